@@ -1,97 +1,454 @@
 #include "activitymanager.h"
 #include "database.h"
+#include "recurrencerule.h"
 #include <QSqlQuery>
 #include <QSqlError>
+#include <QSqlDatabase>
+#include <QSqlRecord>
 #include <QDateTime>
 #include <QUuid>
+#include <QTimeZone>
 #include <QDebug>
+#include <algorithm>
+#include <cstdlib>
+
+namespace
+{
+    // Maps events columns to their JSON keys. Columns not listed here (such as
+    // the epoch shadow columns) are never serialized.
+    struct EventColumn
+    {
+        const char *column;
+        const char *key;
+        bool isBool;
+    };
+
+    const EventColumn eventColumns[] = {
+        {"id", "id", false},
+        {"category", "category", false},
+        {"start_date", "startDate", false},
+        {"end_date", "endDate", false},
+        {"title", "title", false},
+        {"color", "color", false},
+        {"description", "description", false},
+        {"reminder_time", "reminderTime", false},
+        {"is_reminder_enabled", "isReminderEnabled", true},
+        {"recurrence_rule", "recurrenceRule", false},
+        {"recurrence_exceptions", "recurrenceExceptions", false},
+    };
+
+    using ResolvedColumn = std::pair<int, const EventColumn *>;
+
+    // Resolves column positions once per result set instead of looking up
+    // every value by name on every row.
+    QList<ResolvedColumn> resolveColumns(const QSqlRecord &record)
+    {
+        QList<ResolvedColumn> columns;
+        for (const EventColumn &column : eventColumns)
+        {
+            int index = record.indexOf(QLatin1String(column.column));
+            if (index >= 0)
+            {
+                columns.append({index, &column});
+            }
+        }
+        return columns;
+    }
+
+    // Appends value as a JSON string literal. Works on UTF-8 bytes: only
+    // quotes, backslashes and control characters need escaping.
+    void appendJsonString(QByteArray &out, const QString &value)
+    {
+        static const char hex[] = "0123456789abcdef";
+        const QByteArray utf8 = value.toUtf8();
+
+        out.append('"');
+        for (char c : utf8)
+        {
+            switch (c)
+            {
+            case '"':
+                out.append("\\\"");
+                break;
+            case '\\':
+                out.append("\\\\");
+                break;
+            case '\n':
+                out.append("\\n");
+                break;
+            case '\r':
+                out.append("\\r");
+                break;
+            case '\t':
+                out.append("\\t");
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    out.append("\\u00");
+                    out.append(hex[(c >> 4) & 0xf]);
+                    out.append(hex[c & 0xf]);
+                }
+                else
+                {
+                    out.append(c);
+                }
+            }
+        }
+        out.append('"');
+    }
+
+    const int defaultPageSize = 100;
+    const int maxPageSize = 1000;
+    const int defaultChangesLimit = 500;
+
+    constexpr qint64 msPerDay = 24LL * 60 * 60 * 1000;
+    // Tombstone purging runs from getChanges() at most this often.
+    constexpr qint64 tombstonePurgeIntervalMs = 60LL * 60 * 1000;
+
+    // Occurrences expanded per series and request, so an open-ended window
+    // cannot produce an unbounded response.
+    const int maxOccurrencesPerSeries = 1000;
+    // Total occurrences kept in the expansion cache.
+    const int occurrenceCacheCost = 20000;
+
+    const char *const insertActivitySql = R"(
+        INSERT INTO events (id, category, start_date, end_date, title, color, description, reminder_time, is_reminder_enabled, start_ms, end_ms, reminder_ms,
+                            recurrence_rule, recurrence_exceptions, recurrence_end_ms)
+        VALUES (:id, :category, :start_date, :end_date, :title, :color, :description, :reminder_time, :is_reminder_enabled, :start_ms, :end_ms, :reminder_ms,
+                :recurrence_rule, :recurrence_exceptions, :recurrence_end_ms)
+    )";
+
+    QString validateRecurrence(const QString &rule, const QString &exceptions)
+    {
+        QString error;
+        if (!rule.isEmpty() && !RecurrenceRule::parse(rule, &error))
+        {
+            return error;
+        }
+
+        bool ok = true;
+        RecurrenceRule::parseExceptions(exceptions, &ok);
+        return ok ? QString() : "recurrenceExceptions must be comma-separated ISO 8601 date-times";
+    }
+
+    // Reminders further than this from the event are rejected as input
+    // mistakes.
+    constexpr qint64 maxReminderOffsetMs = 366LL * 24 * 60 * 60 * 1000;
+
+    QString readReminderOffset(const QJsonObject &data, qint64 *offsetMs)
+    {
+        const QJsonValue value = data["offsetMs"];
+        if (!value.isDouble() || value.toDouble() != double(value.toInteger()))
+        {
+            return "offsetMs must be an integer number of milliseconds before the event start";
+        }
+        *offsetMs = value.toInteger();
+        if (std::abs(*offsetMs) > maxReminderOffsetMs)
+        {
+            return "offsetMs must be within a year of the event start";
+        }
+        return QString();
+    }
+
+    // One-off reminders get their exact trigger, already fired if it has
+    // passed. Series triggers are left to the scheduler, which picks the
+    // next occurrence from now on.
+    void armReminder(ReminderRecord &reminder, const EventRecord &event)
+    {
+        reminder.recurring = event.isRecurring();
+        reminder.triggerMs.reset();
+        reminder.fired = false;
+        if (!reminder.recurring)
+        {
+            reminder.triggerMs = event.startMs - reminder.offsetMs;
+            reminder.fired = *reminder.triggerMs < QDateTime::currentMSecsSinceEpoch();
+        }
+    }
+
+    QVariant textOrNull(const QString &text)
+    {
+        return text.isEmpty() ? QVariant(QMetaType::fromType<QString>()) : QVariant(text);
+    }
+}
 
 ActivityManager::ActivityManager(QObject *parent)
-    : QObject(parent)
+    : QObject(parent), m_occurrenceCache(occurrenceCacheCost)
 {
+    m_revision = latestRevision();
 }
 
-QJsonObject ActivityManager::createActivity(const QJsonObject &data)
+void ActivityManager::setOptions(const Options &options)
 {
-    QSqlQuery query(Database::instance().db());
+    m_options = options;
+    if (!m_options.cacheEnabled)
+    {
+        m_cacheLoaded = false;
+        m_cache.reset({});
+    }
+}
 
-    QString id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+bool ActivityManager::cacheReady()
+{
+    if (!m_options.cacheEnabled)
+    {
+        return false;
+    }
+    if (m_cacheLoaded)
+    {
+        return true;
+    }
 
-    query.prepare(R"(
-        INSERT INTO events (id, category, start_date, end_date, title, color, description, reminder_time, is_reminder_enabled)
-        VALUES (:id, :category, :start_date, :end_date, :title, :color, :description, :reminder_time, :is_reminder_enabled)
-    )");
+    QMutexLocker locker(&m_writeMutex);
+    if (m_cacheLoaded)
+    {
+        return true;
+    }
 
-    query.bindValue(":id", id);
-    query.bindValue(":category", data["category"].toString());
-    query.bindValue(":start_date", data["startDate"].toString());
-    query.bindValue(":end_date", data["endDate"].toString());
-    query.bindValue(":title", data["title"].toString());
-    query.bindValue(":color", data["color"].toString());
-    query.bindValue(":description", data["description"].toString(""));
+    PreparedQuery query = Database::instance().prepare("activity.all", "SELECT * FROM events ORDER BY start_ms ASC");
+    if (!query->exec())
+    {
+        qDebug() << "ERROR loading event cache:" << query->lastError().text();
+        return false;
+    }
 
-    if (data.contains("reminderTime") && !data["reminderTime"].toString().isEmpty())
+    QList<EventRecord> records;
+    while (query->next())
     {
-        query.bindValue(":reminder_time", data["reminderTime"].toString());
+        records.append(recordFromQuery(*query));
     }
-    else
+    m_cache.reset(records);
+    m_cacheLoaded = true;
+
+    qDebug() << "Event cache loaded with" << records.size() << "events";
+    return true;
+}
+
+QJsonObject ActivityManager::createActivity(const QJsonObject &data)
+{
+    QString error = validateActivity(data);
+    if (!error.isEmpty())
     {
-        query.bindValue(":reminder_time", QVariant(QMetaType::fromType<QString>()));
+        return QJsonObject{{"error", error}};
     }
 
-    query.bindValue(":is_reminder_enabled", data["isReminderEnabled"].toBool(false) ? 1 : 0);
+    QString id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    QMutexLocker locker(&m_writeMutex);
+
+    PreparedQuery query = Database::instance().prepare("activity.insertReturning", QString(insertActivitySql) + " RETURNING *");
 
-    if (!query.exec())
+    query->bindValue(":id", id);
+    bindActivityColumns(*query, data);
+
+    if (!query->exec() || !query->next())
     {
-        qDebug() << "ERROR creating event:" << query.lastError().text();
+        qDebug() << "ERROR creating event:" << query->lastError().text();
         qDebug() << "Data received:" << data;
         return QJsonObject{{"error", "Failed to create event"}};
     }
 
+    // Answer with the row as stored, not the input it was bound from. With
+    // RETURNING the insert only commits once the statement is finished, so
+    // that happens before the revision and signals announce it.
+    EventRecord record = recordFromQuery(*query);
+    query->finish();
+    if (m_cacheLoaded)
+    {
+        m_cache.upsert(record);
+    }
+    m_revision = latestRevision();
+    locker.unlock();
+
     emit activityCreated(id);
 
-    return getActivityById(id);
+    return record.toJson();
+}
+
+QJsonObject ActivityManager::createActivities(const QJsonArray &items)
+{
+    QSqlDatabase db = Database::instance().db();
+    QJsonArray ids;
+    QJsonArray errors;
+    QStringList createdIds;
+    QList<EventRecord> created;
+    QMutexLocker locker(&m_writeMutex);
+
+    if (!db.transaction())
+    {
+        qDebug() << "ERROR starting import transaction:" << db.lastError().text();
+        return QJsonObject{{"error", "Failed to start import"}};
+    }
+
+    {
+        PreparedQuery query = Database::instance().prepare("activity.insert", insertActivitySql);
+
+        for (int i = 0; i < items.size(); ++i)
+        {
+            QString error = validateActivity(items[i]);
+            if (error.isEmpty())
+            {
+                QString id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+                query->bindValue(":id", id);
+                bindActivityColumns(*query, items[i].toObject());
+
+                if (query->exec())
+                {
+                    ids.append(id);
+                    createdIds.append(id);
+                    created.append(EventRecord::fromJson(id, items[i].toObject()));
+                    continue;
+                }
+                error = query->lastError().text();
+            }
+
+            errors.append(QJsonObject{{"index", i}, {"error", error}});
+        }
+    }
+
+    if (!db.commit())
+    {
+        qDebug() << "ERROR committing import:" << db.lastError().text();
+        db.rollback();
+        return QJsonObject{{"error", "Failed to commit import"}};
+    }
+
+    if (m_cacheLoaded)
+    {
+        for (const EventRecord &record : created)
+        {
+            m_cache.upsert(record);
+        }
+    }
+    if (!created.isEmpty())
+    {
+        m_revision = latestRevision();
+    }
+    locker.unlock();
+
+    qDebug() << "Imported" << createdIds.size() << "of" << items.size() << "events";
+    for (const QString &id : createdIds)
+    {
+        emit activityCreated(id);
+    }
+
+    return QJsonObject{{"ids", ids}, {"errors", errors}};
 }
 
 QJsonArray ActivityManager::getAllActivities()
 {
-    QSqlQuery query(Database::instance().db());
+    if (cacheReady())
+    {
+        return toJsonArray(m_cache.all());
+    }
+
+    PreparedQuery query = Database::instance().prepare("activity.all", "SELECT * FROM events ORDER BY start_ms ASC");
 
-    if (!query.exec("SELECT * FROM events ORDER BY start_date ASC"))
+    if (!query->exec())
     {
-        qDebug() << "ERROR fetching events:" << query.lastError().text();
+        qDebug() << "ERROR fetching events:" << query->lastError().text();
         return QJsonArray();
     }
 
-    QJsonArray events;
-    while (query.next())
+    return activitiesFromQuery(*query);
+}
+
+bool ActivityManager::streamAllActivities(const std::function<bool(const QByteArray &)> &sink, int chunkSize)
+{
+    PreparedQuery query = Database::instance().prepare("activity.all", "SELECT * FROM events ORDER BY start_ms ASC");
+
+    if (!query->exec())
     {
-        events.append(activityFromQuery(query));
+        qDebug() << "ERROR streaming events:" << query->lastError().text();
+        return false;
     }
 
-    return events;
+    const QList<ResolvedColumn> columns = resolveColumns(query->record());
+
+    // Serialize rows straight from the cursor into a bounded buffer, handing
+    // it to the sink whenever it fills up.
+    QByteArray buffer;
+    buffer.reserve(chunkSize + 4096);
+    buffer.append('[');
+    bool first = true;
+
+    while (query->next())
+    {
+        buffer.append(first ? "{" : ",{");
+        first = false;
+
+        bool firstField = true;
+        for (const auto &[index, column] : columns)
+        {
+            if (!firstField)
+            {
+                buffer.append(',');
+            }
+            firstField = false;
+
+            buffer.append('"').append(column->key).append("\":");
+            if (column->isBool)
+            {
+                buffer.append(query->value(index).toBool() ? "true" : "false");
+            }
+            else
+            {
+                appendJsonString(buffer, query->value(index).toString());
+            }
+        }
+        buffer.append('}');
+
+        if (buffer.size() >= chunkSize)
+        {
+            if (!sink(buffer))
+            {
+                return false;
+            }
+            buffer.clear();
+        }
+    }
+
+    buffer.append(']');
+    return sink(buffer);
 }
 
 QJsonObject ActivityManager::getActivityById(const QString &id)
 {
-    QSqlQuery query(Database::instance().db());
-    query.prepare("SELECT * FROM events WHERE id = :id");
-    query.bindValue(":id", id);
+    if (cacheReady())
+    {
+        std::optional<EventRecord> record = m_cache.find(id);
+        if (!record)
+        {
+            return QJsonObject{{"error", "Event not found"}, {"status", 404}};
+        }
+        return record->toJson();
+    }
 
-    if (!query.exec() || !query.next())
+    PreparedQuery query = Database::instance().prepare("activity.byId", "SELECT * FROM events WHERE id = :id");
+    query->bindValue(":id", id);
+
+    if (!query->exec())
+    {
+        qDebug() << "ERROR fetching event:" << query->lastError().text();
+        return QJsonObject{{"error", "Failed to fetch event"}, {"status", 500}};
+    }
+    if (!query->next())
     {
-        qDebug() << "ERROR fetching event:" << query.lastError().text();
-        return QJsonObject{{"error", "Event not found"}};
+        return QJsonObject{{"error", "Event not found"}, {"status", 404}};
     }
 
-    return activityFromQuery(query);
+    return activityFromQuery(*query);
 }
 
 QJsonObject ActivityManager::updateActivity(const QString &id, const QJsonObject &data)
 {
-    QSqlQuery query(Database::instance().db());
+    QString error = validateActivity(data);
+    if (!error.isEmpty())
+    {
+        return QJsonObject{{"error", error}};
+    }
 
-    query.prepare(R"(
+    QMutexLocker locker(&m_writeMutex);
+    PreparedQuery query = Database::instance().prepare("activity.update", R"(
         UPDATE events SET
             category = :category,
             start_date = :start_date,
@@ -100,128 +457,1051 @@ QJsonObject ActivityManager::updateActivity(const QString &id, const QJsonObject
             color = :color,
             description = :description,
             reminder_time = :reminder_time,
-            is_reminder_enabled = :is_reminder_enabled
+            is_reminder_enabled = :is_reminder_enabled,
+            start_ms = :start_ms,
+            end_ms = :end_ms,
+            reminder_ms = :reminder_ms,
+            recurrence_rule = :recurrence_rule,
+            recurrence_exceptions = :recurrence_exceptions,
+            recurrence_end_ms = :recurrence_end_ms
         WHERE id = :id
+        RETURNING *
     )");
 
-    query.bindValue(":id", id);
-    query.bindValue(":category", data["category"].toString());
-    query.bindValue(":start_date", data["startDate"].toString());
-    query.bindValue(":end_date", data["endDate"].toString());
-    query.bindValue(":title", data["title"].toString());
-    query.bindValue(":color", data["color"].toString());
-    query.bindValue(":description", data["description"].toString(""));
+    query->bindValue(":id", id);
+    bindActivityColumns(*query, data);
 
-    if (data.contains("reminderTime") && !data["reminderTime"].toString().isEmpty())
+    if (!query->exec())
     {
-        query.bindValue(":reminder_time", data["reminderTime"].toString());
+        qDebug() << "ERROR updating event:" << query->lastError().text();
+        return QJsonObject{{"error", "Failed to update event"}};
     }
-    else
+
+    if (!query->next())
     {
-        query.bindValue(":reminder_time", QVariant(QMetaType::fromType<QString>()));
+        return QJsonObject{{"error", "Event not found"}, {"status", 404}};
     }
 
-    query.bindValue(":is_reminder_enabled", data["isReminderEnabled"].toBool(false) ? 1 : 0);
+    // Finished here so the update commits before it is announced.
+    EventRecord record = recordFromQuery(*query);
+    query->finish();
+    if (m_cacheLoaded)
+    {
+        m_cache.upsert(record);
+    }
+    invalidateOccurrences(id);
+    m_revision = latestRevision();
+    locker.unlock();
+
+    emit activityUpdated(id);
+    // A full replace may move any reminder.
+    emit remindersChanged(id);
+    return record.toJson();
+}
+
+QJsonObject ActivityManager::patchActivity(const QString &id, const QJsonObject &data)
+{
+    // Build the SET clause in column order so equal field sets share one
+    // cached statement. Dates also refresh their epoch shadow column.
+    QStringList assignments;
+    QList<std::pair<QString, QVariant>> values;
+    for (const EventColumn &column : eventColumns)
+    {
+        const QString key = QLatin1String(column.key);
+        if (key == "id" || !data.contains(key))
+        {
+            continue;
+        }
 
-    if (!query.exec())
+        const QJsonValue value = data.value(key);
+        const QString name = QLatin1String(column.column);
+        if (column.isBool)
+        {
+            if (!value.isBool())
+            {
+                return QJsonObject{{"error", QString("%1 must be a boolean").arg(key)}};
+            }
+            values.append({name, value.toBool() ? 1 : 0});
+        }
+        else if (!value.isString() && !value.isNull())
+        {
+            return QJsonObject{{"error", QString("%1 must be a string").arg(key)}};
+        }
+        else if (key == "title" && value.toString().isEmpty())
+        {
+            return QJsonObject{{"error", "title cannot be empty"}};
+        }
+        else if (key == "recurrenceRule" || key == "recurrenceExceptions")
+        {
+            QString error = key == "recurrenceRule" ? validateRecurrence(value.toString(), QString())
+                                                    : validateRecurrence(QString(), value.toString());
+            if (!error.isEmpty())
+            {
+                return QJsonObject{{"error", error}};
+            }
+            values.append({name, textOrNull(value.toString())});
+        }
+        else if (key == "startDate" || key == "endDate" || key == "reminderTime")
+        {
+            const QString text = value.toString();
+            const QVariant ms = Database::toEpochMs(text);
+            if (ms.isNull() && (key != "reminderTime" || !text.isEmpty()))
+            {
+                return QJsonObject{{"error", QString("%1 must be an ISO 8601 date-time").arg(key)}};
+            }
+
+            const QString shadow = key == "startDate" ? "start_ms" : key == "endDate" ? "end_ms" : "reminder_ms";
+            values.append({name, text.isEmpty() ? QVariant(QMetaType::fromType<QString>()) : QVariant(text)});
+            values.append({shadow, ms});
+            assignments.append(QString("%1 = :%1").arg(name));
+            assignments.append(QString("%1 = :%1").arg(shadow));
+            continue;
+        }
+        else
+        {
+            values.append({name, value.toString()});
+        }
+        assignments.append(QString("%1 = :%1").arg(name));
+    }
+
+    for (auto it = data.constBegin(); it != data.constEnd(); ++it)
     {
-        qDebug() << "ERROR updating event:" << query.lastError().text();
-        return QJsonObject{{"error", "Failed to update event"}};
+        bool known = std::any_of(std::begin(eventColumns), std::end(eventColumns), [&](const EventColumn &column)
+                                 { return it.key() == QLatin1String(column.key); });
+        if (!known)
+        {
+            return QJsonObject{{"error", QString("Unknown field: %1").arg(it.key())}};
+        }
+    }
+
+    if (assignments.isEmpty())
+    {
+        return QJsonObject{{"error", "No fields to update"}};
+    }
+
+    QMutexLocker locker(&m_writeMutex);
+
+    // The series bound depends on the start, end and rule together, so it
+    // is computed from the stored row with the patch applied and written
+    // by the same statement.
+    if (data.contains("startDate") || data.contains("endDate") || data.contains("recurrenceRule"))
+    {
+        PreparedQuery current = Database::instance().prepare("activity.byId", "SELECT * FROM events WHERE id = :id");
+        current->bindValue(":id", id);
+        if (!current->exec())
+        {
+            qDebug() << "ERROR patching event:" << current->lastError().text();
+            return QJsonObject{{"error", "Failed to update event"}};
+        }
+        if (!current->next())
+        {
+            return QJsonObject{{"error", "Event not found"}, {"status", 404}};
+        }
+
+        QJsonObject merged = recordFromQuery(*current).toJson();
+        for (auto it = data.constBegin(); it != data.constEnd(); ++it)
+        {
+            merged[it.key()] = it.value();
+        }
+        std::optional<qint64> recurrenceEndMs = EventRecord::fromJson(id, merged).recurrenceEndMs;
+        values.append({"recurrence_end_ms", recurrenceEndMs ? QVariant(qlonglong(*recurrenceEndMs)) : QVariant(QMetaType::fromType<qlonglong>())});
+        assignments.append("recurrence_end_ms = :recurrence_end_ms");
     }
 
+    const QString sql = QString("UPDATE events SET %1 WHERE id = :id RETURNING *").arg(assignments.join(", "));
+    EventRecord record;
+    {
+        PreparedQuery query = Database::instance().prepare("activity.patch:" + sql, sql);
+        query->bindValue(":id", id);
+        for (const auto &[name, value] : values)
+        {
+            query->bindValue(":" + name, value);
+        }
+
+        if (!query->exec())
+        {
+            qDebug() << "ERROR patching event:" << query->lastError().text();
+            return QJsonObject{{"error", "Failed to update event"}};
+        }
+
+        if (!query->next())
+        {
+            return QJsonObject{{"error", "Event not found"}, {"status", 404}};
+        }
+        record = recordFromQuery(*query);
+    }
+
+    if (m_cacheLoaded)
+    {
+        m_cache.upsert(record);
+    }
+    invalidateOccurrences(id);
+    m_revision = latestRevision();
+    locker.unlock();
+
     emit activityUpdated(id);
-    return getActivityById(id);
+    // Only these fields move reminder triggers; other edits leave the
+    // scheduler alone.
+    for (const char *key : {"startDate", "reminderTime", "isReminderEnabled", "recurrenceRule", "recurrenceExceptions"})
+    {
+        if (data.contains(QLatin1String(key)))
+        {
+            emit remindersChanged(id);
+            break;
+        }
+    }
+    return record.toJson();
 }
 
-bool ActivityManager::deleteActivity(const QString &id)
+QJsonObject ActivityManager::deleteActivity(const QString &id)
 {
-    QSqlQuery query(Database::instance().db());
-    query.prepare("DELETE FROM events WHERE id = :id");
-    query.bindValue(":id", id);
+    QMutexLocker locker(&m_writeMutex);
+    PreparedQuery query = Database::instance().prepare("activity.delete", "DELETE FROM events WHERE id = :id");
+    query->bindValue(":id", id);
 
-    if (!query.exec())
+    if (!query->exec())
     {
-        qDebug() << "ERROR deleting event:" << query.lastError().text();
-        return false;
+        qDebug() << "ERROR deleting event:" << query->lastError().text();
+        return QJsonObject{{"error", "Failed to delete event"}};
+    }
+
+    if (query->numRowsAffected() == 0)
+    {
+        return QJsonObject{{"error", "Event not found"}, {"status", 404}};
     }
 
+    if (m_cacheLoaded)
+    {
+        m_cache.remove(id);
+    }
+    invalidateOccurrences(id);
+    m_revision = latestRevision();
+    locker.unlock();
+
     emit activityDeleted(id);
-    return true;
+    return QJsonObject{{"message", "Event deleted successfully"}};
 }
 
 QJsonArray ActivityManager::getActivitiesByDate(const QString &date)
 {
-    QSqlQuery query(Database::instance().db());
-    query.prepare(R"(
-        SELECT * FROM events 
-        WHERE DATE(start_date) <= :date AND DATE(end_date) >= :date
-        ORDER BY start_date ASC
-    )");
-    query.bindValue(":date", date);
-
-    if (!query.exec())
+    QDate day = QDate::fromString(date, Qt::ISODate);
+    if (!day.isValid())
     {
-        qDebug() << "ERROR fetching events by date:" << query.lastError().text();
+        qDebug() << "ERROR fetching events by date: invalid date" << date;
         return QJsonArray();
     }
 
-    QJsonArray events;
-    while (query.next())
+    qint64 dayStart = QDateTime(day, QTime(0, 0)).toMSecsSinceEpoch();
+    qint64 dayEnd = QDateTime(day.addDays(1), QTime(0, 0)).toMSecsSinceEpoch();
+    return getActivitiesInRange(dayStart, dayEnd - 1);
+}
+
+QJsonArray ActivityManager::getActivitiesInRange(qint64 fromMs, qint64 toMs)
+{
+    if (cacheReady())
+    {
+        QJsonArray events = toJsonArray(m_cache.overlapping(fromMs, toMs));
+        for (const EventRecord &series : m_cache.recurring(fromMs, toMs))
+        {
+            for (const EventRecord &occurrence : expandSeries(series, fromMs, toMs))
+            {
+                events.append(occurrence.toJson());
+            }
+        }
+        return events;
+    }
+
+    // Without the cache (--no-event-cache), the R*Tree narrows candidates
+    // to overlapping intervals even when long multi-day events exist; the
+    // exact epoch columns are re-checked because the tree stores rounded
+    // coordinates.
+    static const QString intervalIndexSql = R"(
+        SELECT e.* FROM events_rtree r
+        JOIN events e ON e.id = r.event_id
+        WHERE r.max_ms >= :from AND r.min_ms <= :to
+        AND e.end_ms >= :from AND e.start_ms <= :to
+        AND e.recurrence_rule IS NULL
+        ORDER BY e.start_ms ASC
+    )";
+    static const QString fallbackSql = R"(
+        SELECT * FROM events
+        WHERE start_ms <= :to AND end_ms >= :from
+        AND recurrence_rule IS NULL
+        ORDER BY start_ms ASC
+    )";
+
+    PreparedQuery query = Database::instance().prepare(
+        "activity.range", Database::instance().hasIntervalIndex() ? intervalIndexSql : fallbackSql);
+    query->bindValue(":from", fromMs);
+    query->bindValue(":to", toMs);
+
+    if (!query->exec())
     {
-        events.append(activityFromQuery(query));
+        qDebug() << "ERROR fetching events in range:" << query->lastError().text();
+        return QJsonArray();
     }
+    QJsonArray events = activitiesFromQuery(*query);
 
+    PreparedQuery seriesQuery = Database::instance().prepare("activity.recurringRange", R"(
+        SELECT * FROM events
+        WHERE recurrence_rule IS NOT NULL
+        AND start_ms <= :to AND (recurrence_end_ms IS NULL OR recurrence_end_ms >= :from)
+    )");
+    seriesQuery->bindValue(":from", fromMs);
+    seriesQuery->bindValue(":to", toMs);
+
+    if (!seriesQuery->exec())
+    {
+        qDebug() << "ERROR fetching recurring events in range:" << seriesQuery->lastError().text();
+        return events;
+    }
+    while (seriesQuery->next())
+    {
+        for (const EventRecord &occurrence : expandSeries(recordFromQuery(*seriesQuery), fromMs, toMs))
+        {
+            events.append(occurrence.toJson());
+        }
+    }
     return events;
 }
 
+QList<EventRecord> ActivityManager::expandSeries(const EventRecord &series, qint64 fromMs, qint64 toMs)
+{
+    // The fingerprint keeps an expansion computed from a record that was
+    // replaced concurrently from ever matching the new one.
+    const size_t fingerprint = qHashMulti(0, series.recurrenceRule, series.recurrenceExceptions, series.startDate, series.endDate);
+    const QString key = QString("%1|%2|%3|%4").arg(series.id).arg(fromMs).arg(toMs).arg(fingerprint);
+    QList<QDateTime> starts;
+    bool cached = false;
+    {
+        QMutexLocker locker(&m_occurrenceMutex);
+        if (const QList<QDateTime> *hit = m_occurrenceCache.object(key))
+        {
+            starts = *hit;
+            cached = true;
+        }
+    }
+
+    if (!cached)
+    {
+        std::optional<RecurrenceRule> rule = RecurrenceRule::parse(series.recurrenceRule);
+        if (!rule || !series.timed)
+        {
+            return {};
+        }
+        starts = rule->occurrences(Database::parseDateTime(series.startDate), series.endMs - series.startMs, fromMs, toMs,
+                                   RecurrenceRule::parseExceptions(series.recurrenceExceptions), maxOccurrencesPerSeries);
+
+        QMutexLocker locker(&m_occurrenceMutex);
+        m_occurrenceCache.insert(key, new QList<QDateTime>(starts), std::max<qsizetype>(1, starts.size()));
+    }
+
+    QList<EventRecord> occurrences;
+    occurrences.reserve(starts.size());
+    for (const QDateTime &start : starts)
+    {
+        occurrences.append(series.occurrenceAt(start));
+    }
+    return occurrences;
+}
+
+void ActivityManager::invalidateOccurrences(const QString &id)
+{
+    const QString prefix = id + '|';
+    QMutexLocker locker(&m_occurrenceMutex);
+    for (const QString &key : m_occurrenceCache.keys())
+    {
+        if (key.startsWith(prefix))
+        {
+            m_occurrenceCache.remove(key);
+        }
+    }
+}
+
+QJsonObject ActivityManager::getActivitiesPage(int limit, const QString &cursor, const QStringList &fields)
+{
+    limit = limit <= 0 ? defaultPageSize : qMin(limit, maxPageSize);
+
+    // id and start_ms are always selected so the next cursor can be built.
+    QStringList columns = {"id", "start_ms"};
+    if (fields.isEmpty())
+    {
+        columns = QStringList{"*"};
+    }
+    for (const QString &field : fields)
+    {
+        auto it = std::find_if(std::begin(eventColumns), std::end(eventColumns), [&field](const EventColumn &column)
+                               { return field == QLatin1String(column.key); });
+        if (it == std::end(eventColumns))
+        {
+            return QJsonObject{{"error", QString("Unknown field: %1").arg(field)}};
+        }
+        if (!columns.contains(QLatin1String(it->column)))
+        {
+            columns.append(QLatin1String(it->column));
+        }
+    }
+
+    qint64 cursorStart = 0;
+    QString cursorId;
+    if (!cursor.isEmpty())
+    {
+        QByteArray decoded = QByteArray::fromBase64(cursor.toLatin1(), QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals);
+        int separator = decoded.indexOf('|');
+        bool ok = false;
+        cursorStart = decoded.left(separator).toLongLong(&ok);
+        if (separator < 0 || !ok)
+        {
+            return QJsonObject{{"error", "Invalid cursor"}};
+        }
+        cursorId = QString::fromUtf8(decoded.mid(separator + 1));
+    }
+
+    // Keyset pagination on (start_ms, id): each page is an index range scan
+    // that starts right after the previous page, whatever the offset.
+    QString sql = QString("SELECT %1 FROM events WHERE %2 ORDER BY start_ms ASC, id ASC LIMIT :limit")
+                      .arg(columns.join(", "),
+                           cursor.isEmpty() ? "start_ms IS NOT NULL" : "(start_ms, id) > (:cursor_start, :cursor_id)");
+    PreparedQuery query = Database::instance().prepare("activity.page:" + sql, sql);
+    query->bindValue(":limit", limit);
+    if (!cursor.isEmpty())
+    {
+        query->bindValue(":cursor_start", cursorStart);
+        query->bindValue(":cursor_id", cursorId);
+    }
+
+    if (!query->exec())
+    {
+        qDebug() << "ERROR fetching events page:" << query->lastError().text();
+        return QJsonObject{{"error", "Failed to fetch events"}};
+    }
+
+    QSqlRecord record = query->record();
+    int idIndex = record.indexOf("id");
+    int startIndex = record.indexOf("start_ms");
+    QString lastId;
+    qint64 lastStart = 0;
+
+    QJsonArray items = activitiesFromQuery(*query, [&](QSqlQuery &row)
+                                           {
+        lastId = row.value(idIndex).toString();
+        lastStart = row.value(startIndex).toLongLong(); });
+
+    QJsonObject page;
+    page["items"] = items;
+    if (items.size() == limit)
+    {
+        QByteArray next = QByteArray::number(lastStart) + '|' + lastId.toUtf8();
+        page["nextCursor"] = QString::fromLatin1(next.toBase64(QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals));
+    }
+    else
+    {
+        page["nextCursor"] = QJsonValue::Null;
+    }
+    return page;
+}
+
 QJsonArray ActivityManager::getUpcomingActivities()
 {
-    QSqlQuery query(Database::instance().db());
-    query.prepare(R"(
-        SELECT * FROM events 
-        WHERE start_date >= :now
-        ORDER BY start_date ASC
+    if (cacheReady())
+    {
+        return toJsonArray(m_cache.startingFrom(QDateTime::currentMSecsSinceEpoch(), 10));
+    }
+
+    PreparedQuery query = Database::instance().prepare("activity.upcoming", R"(
+        SELECT * FROM events
+        WHERE start_ms >= :now
+        ORDER BY start_ms ASC
         LIMIT 10
     )");
-    query.bindValue(":now", currentDateTime());
+    query->bindValue(":now", QDateTime::currentMSecsSinceEpoch());
 
-    if (!query.exec())
+    if (!query->exec())
     {
-        qDebug() << "ERROR fetching upcoming events:" << query.lastError().text();
+        qDebug() << "ERROR fetching upcoming events:" << query->lastError().text();
         return QJsonArray();
     }
 
+    return activitiesFromQuery(*query);
+}
+
+bool ActivityManager::markAsCompleted(const QString &id, bool completed)
+{
+    qDebug() << "markAsCompleted called but not implemented for events";
+    return true;
+}
+
+std::optional<EventRecord> ActivityManager::findRecord(const QString &id)
+{
+    if (cacheReady())
+    {
+        return m_cache.find(id);
+    }
+
+    PreparedQuery query = Database::instance().prepare("activity.byId", "SELECT * FROM events WHERE id = :id");
+    query->bindValue(":id", id);
+    if (!query->exec() || !query->next())
+    {
+        return std::nullopt;
+    }
+    return recordFromQuery(*query);
+}
+
+QJsonObject ReminderRecord::toJson() const
+{
+    QJsonObject obj;
+    obj["id"] = id;
+    obj["eventId"] = eventId;
+    obj["offsetMs"] = offsetMs;
+    obj["triggerTime"] = triggerMs ? QJsonValue(QDateTime::fromMSecsSinceEpoch(*triggerMs, QTimeZone::UTC).toString(Qt::ISODate))
+                                   : QJsonValue();
+    obj["fired"] = fired;
+    obj["isDefault"] = isDefault();
+    return obj;
+}
+
+QJsonObject ActivityManager::getReminders(const QString &eventId)
+{
+    if (!findRecord(eventId))
+    {
+        return QJsonObject{{"error", "Event not found"}, {"status", 404}};
+    }
+
+    PreparedQuery query = Database::instance().prepare("reminder.byEvent", R"(
+        SELECT r.*, e.recurrence_rule IS NOT NULL AS recurring
+        FROM reminders r JOIN events e ON e.id = r.event_id
+        WHERE r.event_id = :event_id
+        ORDER BY r.offset_ms DESC
+    )");
+    query->bindValue(":event_id", eventId);
+
+    if (!query->exec())
+    {
+        qDebug() << "ERROR fetching reminders:" << query->lastError().text();
+        return QJsonObject{{"error", "Failed to fetch reminders"}, {"status", 500}};
+    }
+
+    QJsonArray reminders;
+    while (query->next())
+    {
+        reminders.append(reminderFromQuery(*query).toJson());
+    }
+    return QJsonObject{{"reminders", reminders}};
+}
+
+QJsonObject ActivityManager::createReminder(const QString &eventId, const QJsonObject &data)
+{
+    qint64 offsetMs = 0;
+    QString error = readReminderOffset(data, &offsetMs);
+    if (!error.isEmpty())
+    {
+        return QJsonObject{{"error", error}};
+    }
+
+    std::optional<EventRecord> event = findRecord(eventId);
+    if (!event)
+    {
+        return QJsonObject{{"error", "Event not found"}, {"status", 404}};
+    }
+    if (!event->timed)
+    {
+        return QJsonObject{{"error", "Event has no valid start time"}};
+    }
+
+    ReminderRecord reminder;
+    reminder.id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    reminder.eventId = eventId;
+    reminder.offsetMs = offsetMs;
+    armReminder(reminder, *event);
+
+    QMutexLocker locker(&m_writeMutex);
+    PreparedQuery query = Database::instance().prepare("reminder.insert", R"(
+        INSERT INTO reminders (id, event_id, offset_ms, trigger_ms, fired)
+        VALUES (:id, :event_id, :offset_ms, :trigger_ms, :fired)
+    )");
+    query->bindValue(":id", reminder.id);
+    query->bindValue(":event_id", reminder.eventId);
+    query->bindValue(":offset_ms", reminder.offsetMs);
+    query->bindValue(":trigger_ms", reminder.triggerMs ? QVariant(*reminder.triggerMs) : QVariant(QMetaType::fromType<qlonglong>()));
+    query->bindValue(":fired", reminder.fired ? 1 : 0);
+
+    if (!query->exec())
+    {
+        qDebug() << "ERROR creating reminder:" << query->lastError().text();
+        return QJsonObject{{"error", "Failed to create reminder"}};
+    }
+    locker.unlock();
+
+    emit remindersChanged(eventId);
+    return reminder.toJson();
+}
+
+QJsonObject ActivityManager::updateReminder(const QString &eventId, const QString &reminderId, const QJsonObject &data)
+{
+    if (reminderId == eventId + ":default")
+    {
+        return QJsonObject{{"error", "The default reminder follows the event's reminderTime; update the event instead"}};
+    }
+
+    qint64 offsetMs = 0;
+    QString error = readReminderOffset(data, &offsetMs);
+    if (!error.isEmpty())
+    {
+        return QJsonObject{{"error", error}};
+    }
+
+    std::optional<EventRecord> event = findRecord(eventId);
+    if (!event)
+    {
+        return QJsonObject{{"error", "Event not found"}, {"status", 404}};
+    }
+
+    ReminderRecord reminder;
+    reminder.id = reminderId;
+    reminder.eventId = eventId;
+    reminder.offsetMs = offsetMs;
+    armReminder(reminder, *event);
+
+    QMutexLocker locker(&m_writeMutex);
+    PreparedQuery query = Database::instance().prepare("reminder.update", R"(
+        UPDATE reminders SET offset_ms = :offset_ms, trigger_ms = :trigger_ms, fired = :fired
+        WHERE id = :id AND event_id = :event_id
+    )");
+    query->bindValue(":offset_ms", reminder.offsetMs);
+    query->bindValue(":trigger_ms", reminder.triggerMs ? QVariant(*reminder.triggerMs) : QVariant(QMetaType::fromType<qlonglong>()));
+    query->bindValue(":fired", reminder.fired ? 1 : 0);
+    query->bindValue(":id", reminderId);
+    query->bindValue(":event_id", eventId);
+
+    if (!query->exec())
+    {
+        qDebug() << "ERROR updating reminder:" << query->lastError().text();
+        return QJsonObject{{"error", "Failed to update reminder"}};
+    }
+    if (query->numRowsAffected() == 0)
+    {
+        return QJsonObject{{"error", "Reminder not found"}, {"status", 404}};
+    }
+    locker.unlock();
+
+    emit remindersChanged(eventId);
+    return reminder.toJson();
+}
+
+QJsonObject ActivityManager::deleteReminder(const QString &eventId, const QString &reminderId)
+{
+    if (reminderId == eventId + ":default")
+    {
+        return QJsonObject{{"error", "The default reminder follows the event's reminderTime; disable it on the event instead"}};
+    }
+
+    QMutexLocker locker(&m_writeMutex);
+    PreparedQuery query = Database::instance().prepare("reminder.delete", "DELETE FROM reminders WHERE id = :id AND event_id = :event_id");
+    query->bindValue(":id", reminderId);
+    query->bindValue(":event_id", eventId);
+
+    if (!query->exec())
+    {
+        qDebug() << "ERROR deleting reminder:" << query->lastError().text();
+        return QJsonObject{{"error", "Failed to delete reminder"}};
+    }
+    if (query->numRowsAffected() == 0)
+    {
+        return QJsonObject{{"error", "Reminder not found"}, {"status", 404}};
+    }
+    locker.unlock();
+
+    emit remindersChanged(eventId);
+    return QJsonObject{{"message", "Reminder deleted successfully"}};
+}
+
+QList<ReminderRecord> ActivityManager::pendingReminders(const QString &eventId)
+{
+    // Walks idx_reminders_trigger_ms; the join is a primary-key lookup per
+    // pending reminder, not a scan of events.
+    PreparedQuery query = eventId.isEmpty()
+                              ? Database::instance().prepare("reminder.pending", R"(
+        SELECT r.*, e.recurrence_rule IS NOT NULL AS recurring
+        FROM reminders r JOIN events e ON e.id = r.event_id
+        WHERE r.fired = 0
+        ORDER BY r.trigger_ms
+    )")
+                              : Database::instance().prepare("reminder.pendingByEvent", R"(
+        SELECT r.*, e.recurrence_rule IS NOT NULL AS recurring
+        FROM reminders r JOIN events e ON e.id = r.event_id
+        WHERE r.event_id = :event_id AND r.fired = 0
+    )");
+    if (!eventId.isEmpty())
+    {
+        query->bindValue(":event_id", eventId);
+    }
+
+    QList<ReminderRecord> reminders;
+    if (!query->exec())
+    {
+        qWarning() << "ERROR loading reminders:" << query->lastError().text();
+        return reminders;
+    }
+    while (query->next())
+    {
+        reminders.append(reminderFromQuery(*query));
+    }
+    return reminders;
+}
+
+bool ActivityManager::completeReminders(const QList<ReminderCompletion> &completions)
+{
+    QSqlDatabase db = Database::instance().db();
+    QMutexLocker locker(&m_writeMutex);
+
+    if (!db.transaction())
+    {
+        qDebug() << "ERROR starting reminder transaction:" << db.lastError().text();
+        return false;
+    }
+
+    QStringList disabledEvents;
+    bool ok = true;
+    {
+        // Compare-and-set: a PUT/PATCH committed after the scheduler took
+        // the reminder has re-armed its row through events_reminders_update.
+        // That edit is kept; the scheduler requeues it on remindersChanged.
+        PreparedQuery query = Database::instance().prepare("reminder.complete", R"(
+            UPDATE reminders SET trigger_ms = :trigger_ms, fired = :fired
+            WHERE id = :id AND trigger_ms IS :seen_trigger_ms AND fired = 0
+        )");
+        for (const ReminderCompletion &completion : completions)
+        {
+            const ReminderRecord &reminder = completion.reminder;
+            query->bindValue(":trigger_ms", reminder.triggerMs ? QVariant(*reminder.triggerMs) : QVariant(QMetaType::fromType<qlonglong>()));
+            query->bindValue(":fired", reminder.fired ? 1 : 0);
+            query->bindValue(":id", reminder.id);
+            query->bindValue(":seen_trigger_ms", completion.seenTriggerMs ? QVariant(*completion.seenTriggerMs) : QVariant(QMetaType::fromType<qlonglong>()));
+            if (!query->exec())
+            {
+                qDebug() << "ERROR completing reminder:" << query->lastError().text();
+                ok = false;
+                break;
+            }
+            if (query->numRowsAffected() == 0)
+            {
+                qDebug() << "Reminder" << reminder.id << "changed since it came due - keeping the new state";
+                continue;
+            }
+            if (reminder.fired && reminder.isDefault())
+            {
+                disabledEvents.append(reminder.eventId);
+            }
+        }
+    }
+    if (ok)
+    {
+        PreparedQuery query = Database::instance().prepare("activity.disableReminder", "UPDATE events SET is_reminder_enabled = 0 WHERE id = :id");
+        for (const QString &id : disabledEvents)
+        {
+            query->bindValue(":id", id);
+            if (!query->exec())
+            {
+                qDebug() << "ERROR disabling reminder:" << query->lastError().text();
+                ok = false;
+                break;
+            }
+        }
+    }
+
+    if (!ok || !db.commit())
+    {
+        if (ok)
+        {
+            qDebug() << "ERROR committing reminder changes:" << db.lastError().text();
+        }
+        db.rollback();
+        return false;
+    }
+
+    if (m_cacheLoaded)
+    {
+        for (const QString &id : disabledEvents)
+        {
+            m_cache.setReminderEnabled(id, false);
+        }
+    }
+    if (!disabledEvents.isEmpty())
+    {
+        m_revision = latestRevision();
+    }
+    return true;
+}
+
+QJsonObject ActivityManager::getChanges(qint64 sinceRevision, int limit)
+{
+    limit = limit <= 0 ? defaultChangesLimit : qMin(limit, maxPageSize);
+    purgeTombstones();
+
+    const qint64 revision = dataRevision();
+    if (sinceRevision > 0)
+    {
+        PreparedQuery purged = Database::instance().prepare("sync.purgedThrough", "SELECT value FROM sync_state WHERE key = 'tombstones_purged_through'");
+        if (purged->exec() && purged->next() && sinceRevision < purged->value(0).toLongLong())
+        {
+            return QJsonObject{{"error", "Change log no longer reaches this revision; refetch all events"}, {"status", 410}};
+        }
+    }
+
+    // e.id is NULL for deleted events; the event columns come from the
+    // join so upserts need no second lookup.
+    PreparedQuery query = Database::instance().prepare("changes.since", R"(
+        SELECT c.revision AS change_revision, c.event_id, c.deleted, e.*
+        FROM changes c LEFT JOIN events e ON e.id = c.event_id
+        WHERE c.revision > :since
+        ORDER BY c.revision
+        LIMIT :limit
+    )");
+    query->bindValue(":since", sinceRevision);
+    query->bindValue(":limit", limit + 1);
+
+    if (!query->exec())
+    {
+        qDebug() << "ERROR fetching changes:" << query->lastError().text();
+        return QJsonObject{{"error", "Failed to fetch changes"}, {"status", 500}};
+    }
+
+    QJsonArray upserts;
+    QJsonArray deletes;
+    qint64 lastRevision = sinceRevision;
+    bool hasMore = false;
+    for (int count = 0; query->next(); ++count)
+    {
+        if (count == limit)
+        {
+            hasMore = true;
+            break;
+        }
+
+        lastRevision = query->value("change_revision").toLongLong();
+        if (query->value("deleted").toBool() || query->value("id").isNull())
+        {
+            deletes.append(query->value("event_id").toString());
+        }
+        else
+        {
+            upserts.append(recordFromQuery(*query).toJson());
+        }
+    }
+
+    return QJsonObject{
+        {"revision", hasMore ? lastRevision : qMax(revision, lastRevision)},
+        {"upserts", upserts},
+        {"deletes", deletes},
+        {"hasMore", hasMore}};
+}
+
+qint64 ActivityManager::latestRevision()
+{
+    // AUTOINCREMENT keeps the high-water mark here even after the newest
+    // rows are replaced or purged.
+    PreparedQuery query = Database::instance().prepare("changes.latest", "SELECT seq FROM sqlite_sequence WHERE name = 'changes'");
+    if (!query->exec() || !query->next())
+    {
+        return 0;
+    }
+    return query->value(0).toLongLong();
+}
+
+void ActivityManager::purgeTombstones()
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    qint64 lastPurge = m_lastPurgeMs.load();
+    if (m_options.tombstoneRetentionDays <= 0 || now - lastPurge < tombstonePurgeIntervalMs ||
+        !m_lastPurgeMs.compare_exchange_strong(lastPurge, now))
+    {
+        return;
+    }
+
+    QSqlDatabase db = Database::instance().db();
+    QMutexLocker locker(&m_writeMutex);
+
+    if (!db.transaction())
+    {
+        qDebug() << "ERROR starting tombstone purge:" << db.lastError().text();
+        return;
+    }
+
+    PreparedQuery newest = Database::instance().prepare("changes.oldTombstones", "SELECT MAX(revision) FROM changes WHERE deleted = 1 AND changed_ms < :cutoff");
+    newest->bindValue(":cutoff", now - m_options.tombstoneRetentionDays * msPerDay);
+    if (!newest->exec() || !newest->next() || newest->value(0).isNull())
+    {
+        db.rollback();
+        return;
+    }
+    const qint64 purgedThrough = newest->value(0).toLongLong();
+    newest->finish();
+
+    PreparedQuery mark = Database::instance().prepare("sync.setPurgedThrough", R"(
+        INSERT INTO sync_state (key, value) VALUES ('tombstones_purged_through', :revision)
+        ON CONFLICT(key) DO UPDATE SET value = MAX(value, excluded.value)
+    )");
+    mark->bindValue(":revision", purgedThrough);
+    PreparedQuery purge = Database::instance().prepare("changes.purgeTombstones", "DELETE FROM changes WHERE deleted = 1 AND revision <= :revision");
+    purge->bindValue(":revision", purgedThrough);
+
+    if (!mark->exec() || !purge->exec() || !db.commit())
+    {
+        qDebug() << "ERROR purging tombstones:" << db.lastError().text();
+        db.rollback();
+        return;
+    }
+    qInfo() << "🧹 Purged" << purge->numRowsAffected() << "change log tombstone(s) through revision" << purgedThrough;
+}
+
+ReminderRecord ActivityManager::reminderFromQuery(QSqlQuery &query)
+{
+    ReminderRecord reminder;
+    reminder.id = query.value("id").toString();
+    reminder.eventId = query.value("event_id").toString();
+    reminder.offsetMs = query.value("offset_ms").toLongLong();
+    QVariant triggerMs = query.value("trigger_ms");
+    if (!triggerMs.isNull())
+    {
+        reminder.triggerMs = triggerMs.toLongLong();
+    }
+    reminder.fired = query.value("fired").toBool();
+    reminder.recurring = query.value("recurring").toBool();
+    return reminder;
+}
+
+QString ActivityManager::validateActivity(const QJsonValue &item) const
+{
+    if (!item.isObject())
+    {
+        return "Event must be a JSON object";
+    }
+
+    QJsonObject data = item.toObject();
+    for (const char *field : {"title", "startDate", "endDate"})
+    {
+        if (data.value(field).toString().isEmpty())
+        {
+            return QString("Missing required field: %1").arg(field);
+        }
+    }
+
+    if (Database::toEpochMs(data["startDate"].toString()).isNull() || Database::toEpochMs(data["endDate"].toString()).isNull())
+    {
+        return "startDate and endDate must be ISO 8601 date-times";
+    }
+
+    // A reminder time that does not parse would be stored without its
+    // trigger and never fire.
+    const QString reminderTime = data["reminderTime"].toString();
+    if (!reminderTime.isEmpty() && Database::toEpochMs(reminderTime).isNull())
+    {
+        return "reminderTime must be an ISO 8601 date-time";
+    }
+
+    return validateRecurrence(data["recurrenceRule"].toString(), data["recurrenceExceptions"].toString());
+}
+
+void ActivityManager::bindActivityColumns(QSqlQuery &query, const QJsonObject &data)
+{
+    query.bindValue(":category", data["category"].toString());
+    query.bindValue(":start_date", data["startDate"].toString());
+    query.bindValue(":end_date", data["endDate"].toString());
+    query.bindValue(":title", data["title"].toString());
+    query.bindValue(":color", data["color"].toString());
+    query.bindValue(":description", data["description"].toString(""));
+
+    if (data.contains("reminderTime") && !data["reminderTime"].toString().isEmpty())
+    {
+        query.bindValue(":reminder_time", data["reminderTime"].toString());
+    }
+    else
+    {
+        query.bindValue(":reminder_time", QVariant(QMetaType::fromType<QString>()));
+    }
+
+    query.bindValue(":is_reminder_enabled", data["isReminderEnabled"].toBool(false) ? 1 : 0);
+    query.bindValue(":start_ms", Database::toEpochMs(data["startDate"].toString()));
+    query.bindValue(":end_ms", Database::toEpochMs(data["endDate"].toString()));
+    query.bindValue(":reminder_ms", Database::toEpochMs(data["reminderTime"].toString()));
+
+    EventRecord record = EventRecord::fromJson(QString(), data);
+    query.bindValue(":recurrence_rule", textOrNull(record.recurrenceRule));
+    query.bindValue(":recurrence_exceptions", textOrNull(record.recurrenceExceptions));
+    query.bindValue(":recurrence_end_ms", record.recurrenceEndMs ? QVariant(qlonglong(*record.recurrenceEndMs))
+                                                                 : QVariant(QMetaType::fromType<qlonglong>()));
+}
+
+QJsonArray ActivityManager::activitiesFromQuery(QSqlQuery &query, const std::function<void(QSqlQuery &)> &onRow)
+{
+    const QList<ResolvedColumn> columns = resolveColumns(query.record());
+
     QJsonArray events;
     while (query.next())
     {
-        events.append(activityFromQuery(query));
+        QJsonObject obj;
+        for (const auto &[index, column] : columns)
+        {
+            QVariant value = query.value(index);
+            obj[QLatin1String(column->key)] = column->isBool ? QJsonValue(value.toBool()) : QJsonValue(value.toString());
+        }
+        events.append(obj);
+
+        if (onRow)
+        {
+            onRow(query);
+        }
     }
 
     return events;
 }
 
-bool ActivityManager::markAsCompleted(const QString &id, bool completed)
+EventRecord ActivityManager::recordFromQuery(QSqlQuery &query)
 {
-    qDebug() << "markAsCompleted called but not implemented for events";
-    return true;
+    EventRecord record;
+    record.id = query.value("id").toString();
+    record.category = query.value("category").toString();
+    record.startDate = query.value("start_date").toString();
+    record.endDate = query.value("end_date").toString();
+    record.title = query.value("title").toString();
+    record.color = query.value("color").toString();
+    record.description = query.value("description").toString();
+    record.reminderTime = query.value("reminder_time").toString();
+    record.isReminderEnabled = query.value("is_reminder_enabled").toBool();
+
+    QVariant startMs = query.value("start_ms");
+    QVariant endMs = query.value("end_ms");
+    record.timed = !startMs.isNull() && !endMs.isNull();
+    record.startMs = startMs.toLongLong();
+    record.endMs = endMs.toLongLong();
+
+    record.recurrenceRule = query.value("recurrence_rule").toString();
+    record.recurrenceExceptions = query.value("recurrence_exceptions").toString();
+    QVariant recurrenceEndMs = query.value("recurrence_end_ms");
+    if (!recurrenceEndMs.isNull())
+    {
+        record.recurrenceEndMs = recurrenceEndMs.toLongLong();
+    }
+    return record;
 }
 
-QString ActivityManager::currentDateTime() const
+QJsonArray ActivityManager::toJsonArray(const QList<EventRecord> &records)
 {
-    return QDateTime::currentDateTime().toString(Qt::ISODate);
+    QJsonArray events;
+    for (const EventRecord &record : records)
+    {
+        events.append(record.toJson());
+    }
+    return events;
 }
 
 QJsonObject ActivityManager::activityFromQuery(QSqlQuery &query)
 {
     QJsonObject obj;
-    obj["id"] = query.value("id").toString();
-    obj["category"] = query.value("category").toString();
-    obj["startDate"] = query.value("start_date").toString();
-    obj["endDate"] = query.value("end_date").toString();
-    obj["title"] = query.value("title").toString();
-    obj["color"] = query.value("color").toString();
-    obj["description"] = query.value("description").toString();
-    obj["reminderTime"] = query.value("reminder_time").toString();
-    obj["isReminderEnabled"] = query.value("is_reminder_enabled").toBool();
+    for (const EventColumn &column : eventColumns)
+    {
+        QVariant value = query.value(QLatin1String(column.column));
+        obj[QLatin1String(column.key)] = column.isBool ? QJsonValue(value.toBool()) : QJsonValue(value.toString());
+    }
     return obj;
 }
\ No newline at end of file
@@ -5,32 +5,150 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QString>
+#include <QStringList>
+#include <QMutex>
+#include <QHash>
+#include <QCache>
+#include <QDateTime>
+#include <atomic>
+#include <functional>
+#include "eventcache.h"
+
+class QSqlQuery;
+
+// One reminders row: fires offsetMs before the start of its event, or of
+// each occurrence of a series. The event's own reminderTime is mirrored as
+// the row with id "<event id>:default".
+struct ReminderRecord
+{
+    QString id;
+    QString eventId;
+    qint64 offsetMs = 0;
+    // Exact trigger for one-off events; lower bound of the next trigger for
+    // a series, nullopt meaning from now on.
+    std::optional<qint64> triggerMs;
+    bool fired = false;
+    bool recurring = false;
+
+    bool isDefault() const { return id == eventId + ":default"; }
+    QJsonObject toJson() const;
+};
+
+// A due reminder's new state, and the trigger the scheduler saw when it
+// came due. Stored only if the row still holds that trigger unfired, so
+// an edit committed in between wins.
+struct ReminderCompletion
+{
+    ReminderRecord reminder;
+    std::optional<qint64> seenTriggerMs;
+};
 
 class ActivityManager : public QObject
 {
     Q_OBJECT
 
 public:
+    // With cacheEnabled, reads are served from an in-memory EventCache that
+    // is loaded on first use and updated write-through by every mutation.
+    // Tombstones in the change log are purged after
+    // tombstoneRetentionDays; clients syncing from before that must refetch.
+    struct Options
+    {
+        bool cacheEnabled = true;
+        int tombstoneRetentionDays = 30;
+    };
+
     explicit ActivityManager(QObject *parent = nullptr);
+    void setOptions(const Options &options);
+
+    // Revision of the last committed change to the events table, taken from
+    // the change log, so readers can tell whether anything changed without
+    // querying. Read it before reading data: the data is then at least as
+    // new as the revision.
+    qint64 dataRevision() const { return m_revision.load(); }
+    // Events changed after sinceRevision, oldest first: {"revision",
+    // "upserts", "deletes", "hasMore"}. Pass "revision" back as the next
+    // sinceRevision. Series are returned as stored, not expanded. 410 when
+    // tombstones after sinceRevision have been purged.
+    QJsonObject getChanges(qint64 sinceRevision, int limit);
 
     QJsonObject createActivity(const QJsonObject &data);
+    // Inserts all items in one transaction. Returns {"ids": [...], "errors":
+    // [{"index", "error"}]} so callers can report per-item failures.
+    QJsonObject createActivities(const QJsonArray &items);
     QJsonArray getAllActivities();
+    // Writes all events as one compact JSON array, in chunks of about
+    // chunkSize bytes, without building QJsonObjects. The sink returns false
+    // to abort. Returns false if the query fails or the sink aborts.
+    bool streamAllActivities(const std::function<bool(const QByteArray &)> &sink, int chunkSize = 64 * 1024);
+    // Keyset page ordered by (start, id). Returns {"items", "nextCursor"};
+    // fields limits each item to the given JSON keys.
+    QJsonObject getActivitiesPage(int limit, const QString &cursor, const QStringList &fields);
+    // Failures return {"error": message} plus an HTTP "status" when it is
+    // not a plain 400 (404 for unknown ids).
     QJsonObject getActivityById(const QString &id);
     QJsonObject updateActivity(const QString &id, const QJsonObject &data);
-    bool deleteActivity(const QString &id);
+    // Writes only the columns whose keys are present in data.
+    QJsonObject patchActivity(const QString &id, const QJsonObject &data);
+    QJsonObject deleteActivity(const QString &id);
 
     QJsonArray getActivitiesByDate(const QString &date);
+    // Events overlapping the inclusive [fromMs, toMs] window (UTC epoch ms).
+    // Recurring series are expanded into their occurrences in the window,
+    // listed after the one-off events; each has "seriesId" set and an id of
+    // the form "<seriesId>@<start ms>".
+    QJsonArray getActivitiesInRange(qint64 fromMs, qint64 toMs);
     QJsonArray getUpcomingActivities();
     bool markAsCompleted(const QString &id, bool completed);
+    std::optional<EventRecord> findRecord(const QString &id);
+
+    // Reminder CRUD under an event. offsetMs is how long before the start
+    // the reminder fires; the default reminder follows the event's
+    // reminderTime and cannot be changed here.
+    QJsonObject getReminders(const QString &eventId);
+    QJsonObject createReminder(const QString &eventId, const QJsonObject &data);
+    QJsonObject updateReminder(const QString &eventId, const QString &reminderId, const QJsonObject &data);
+    QJsonObject deleteReminder(const QString &eventId, const QString &reminderId);
+    // Unfired reminders, read off the trigger index; of one event when
+    // eventId is set.
+    QList<ReminderRecord> pendingReminders(const QString &eventId = QString());
+    // Stores the new trigger/fired state of each reminder in one
+    // transaction, skipping reminders changed since they came due. A fired
+    // default reminder also disables the event's isReminderEnabled flag.
+    bool completeReminders(const QList<ReminderCompletion> &completions);
 
 signals:
     void activityCreated(const QString &id);
     void activityUpdated(const QString &id);
     void activityDeleted(const QString &id);
+    // An event's reminder triggers may have moved: its reminders were
+    // edited, or a PUT/PATCH touched its start, reminder or recurrence.
+    void remindersChanged(const QString &eventId);
 
 private:
-    QString currentDateTime() const;
+    bool cacheReady();
+    EventRecord recordFromQuery(QSqlQuery &query);
+    QJsonArray toJsonArray(const QList<EventRecord> &records);
+    QString validateActivity(const QJsonValue &item) const;
+    void bindActivityColumns(QSqlQuery &query, const QJsonObject &data);
     QJsonObject activityFromQuery(class QSqlQuery &query);
+    QJsonArray activitiesFromQuery(QSqlQuery &query, const std::function<void(QSqlQuery &)> &onRow = nullptr);
+    QList<EventRecord> expandSeries(const EventRecord &series, qint64 fromMs, qint64 toMs);
+    void invalidateOccurrences(const QString &id);
+    ReminderRecord reminderFromQuery(QSqlQuery &query);
+    qint64 latestRevision();
+    void purgeTombstones();
+
+    Options m_options;
+    EventCache m_cache;
+    std::atomic<bool> m_cacheLoaded{false};
+    std::atomic<qint64> m_revision{0};
+    std::atomic<qint64> m_lastPurgeMs{0};
+    // Serializes writes so the database and the cache apply them in the same order.
+    QMutex m_writeMutex;
+    // Occurrence starts per (series id, window), bounded LRU by total count.
+    QCache<QString, QList<QDateTime>> m_occurrenceCache;
+    QMutex m_occurrenceMutex;
 };
 
 #endif
\ No newline at end of file
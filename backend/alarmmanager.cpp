@@ -1,240 +1,441 @@
 #include "alarmmanager.h"
-#include "database.h"
-#include <QSqlQuery>
-#include <QSqlError>
+#include "activitymanager.h"
+#include "notificationdispatcher.h"
 #include <QDateTime>
 #include <QDebug>
-#include <QProcess>
-#include <QFile>
+#include <QThread>
+#include <QCoreApplication>
+#include <algorithm>
+#include <cstdlib>
 
-AlarmManager::AlarmManager(QObject *parent)
-    : QObject(parent), m_trayIcon(nullptr)
+namespace
 {
-    m_checkTimer = new QTimer(this);
-    connect(m_checkTimer, &QTimer::timeout, this, &AlarmManager::onTimerTimeout);
-    m_checkTimer->start(10000);
+    // QTimer intervals are an int of milliseconds; alarms further out are
+    // reached by re-arming when this cap expires.
+    constexpr qint64 maxTimerIntervalMs = 24LL * 24 * 60 * 60 * 1000;
 
-    loadActiveAlarms();
+    // Above this many alarms in one tick, a single summary notification is
+    // shown instead of one per event.
+    constexpr int maxIndividualNotifications = 3;
 
-    qInfo() << "⏰ AlarmManager started - checking every 30 seconds";
+    // Wall-clock and monotonic time may disagree by this much before the
+    // difference is reported as a clock jump or resume.
+    constexpr qint64 clockJumpThresholdMs = 2000;
 }
 
-void AlarmManager::setSystemTrayIcon(QSystemTrayIcon *trayIcon)
+AlarmManager::AlarmManager(ActivityManager *activityManager, NotificationDispatcher *notifier)
+    : QObject(nullptr), m_activityManager(activityManager), m_notifier(notifier), m_armedAtMs(0), m_thread(nullptr), m_startedMs(0)
 {
-    m_trayIcon = trayIcon;
+    m_checkTimer = new QTimer(this);
+    m_checkTimer->setSingleShot(true);
+    m_checkTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_checkTimer, &QTimer::timeout, this, &AlarmManager::onTimerTimeout);
+
+    // ActivityManager emits from HTTP worker threads, so these are queued
+    // onto this object's thread.
+    connect(m_activityManager, &ActivityManager::activityCreated, this, &AlarmManager::onRemindersChanged);
+    connect(m_activityManager, &ActivityManager::remindersChanged, this, &AlarmManager::onRemindersChanged);
+    connect(m_activityManager, &ActivityManager::activityDeleted, this, &AlarmManager::onActivityDeleted);
 }
 
-void AlarmManager::reloadAlarms()
+void AlarmManager::setOptions(const Options &options)
 {
-    loadActiveAlarms();
+    m_options = options;
 }
 
-void AlarmManager::checkAlarms()
+AlarmManager::~AlarmManager()
 {
-    QDateTime now = QDateTime::currentDateTime();
+    stop();
+}
 
-    static int checkCount = 0;
-    checkCount++;
-    if (checkCount % 10 == 1)
+void AlarmManager::start()
+{
+    if (m_thread)
     {
-        qInfo() << "⏰ Checking alarms... (check #" << checkCount << ")";
+        return;
     }
 
-    QSqlQuery query(Database::instance().db());
-    query.prepare(R"(
-        SELECT id, title, category, reminder_time, start_date
-        FROM events
-        WHERE is_reminder_enabled = 1
-        AND reminder_time IS NOT NULL
-        AND datetime(reminder_time) <= datetime('now', 'localtime')
-    )");
+    m_thread = new QThread();
+    m_thread->setObjectName("alarm-scheduler");
+    moveToThread(m_thread);
+    m_thread->start(QThread::HighPriority);
+
+    // Loading runs on the alarm thread, so it opens that thread's own
+    // database connection and the timer is started where it lives.
+    QMetaObject::invokeMethod(this, [this]()
+                              {
+        m_startedMs = QDateTime::currentMSecsSinceEpoch();
+        loadActiveAlarms();
+        qInfo() << "⏰ AlarmManager started on its own thread - timer follows the next due alarm"; }, Qt::QueuedConnection);
+}
 
-    if (!query.exec())
+void AlarmManager::stop()
+{
+    if (!m_thread)
     {
-        qWarning() << "❌ Failed to check alarms:" << query.lastError().text();
         return;
     }
 
-    int triggeredCount = 0;
-    while (query.next())
-    {
-        QString eventId = query.value("id").toString();
-        QString title = query.value("title").toString();
-        QString category = query.value("category").toString();
-        QString reminderTime = query.value("reminder_time").toString();
-        QString startDate = query.value("start_date").toString();
+    // Stop the timer on its own thread and hand the object back to the
+    // main thread so it can be destroyed there.
+    QThread *mainThread = QCoreApplication::instance()->thread();
+    QMetaObject::invokeMethod(this, [this, mainThread]()
+                              {
+        m_checkTimer->stop();
+        moveToThread(mainThread); }, Qt::BlockingQueuedConnection);
+
+    m_thread->quit();
+    m_thread->wait();
+    delete m_thread;
+    m_thread = nullptr;
+}
 
-        qInfo() << "🔔 ALARM TRIGGERED!" << "Event:" << title << "Category:" << category << "ID:" << eventId;
+QJsonObject AlarmManager::latencyStats() const
+{
+    QMutexLocker locker(&m_statsMutex);
+    return QJsonObject{
+        {"fired", m_latency.count},
+        {"missed", m_latency.missed},
+        {"expired", m_latency.expired},
+        {"lastMs", m_latency.lastMs},
+        {"maxMs", m_latency.maxMs},
+        {"avgMs", m_latency.count > 0 ? double(m_latency.totalMs) / m_latency.count : 0.0}};
+}
+
+void AlarmManager::recordLatency(qint64 latencyMs)
+{
+    QMutexLocker locker(&m_statsMutex);
+    m_latency.count++;
+    m_latency.lastMs = latencyMs;
+    m_latency.maxMs = std::max(m_latency.maxMs, latencyMs);
+    m_latency.totalMs += latencyMs;
+}
 
-        showNotification(eventId, title, category, startDate);
-        emit alarmTriggered(eventId, title);
+void AlarmManager::recordCatchUp(int missed, int expired)
+{
+    QMutexLocker locker(&m_statsMutex);
+    m_latency.missed += missed;
+    m_latency.expired += expired;
+}
 
-        QSqlQuery updateQuery(Database::instance().db());
-        updateQuery.prepare("UPDATE events SET is_reminder_enabled = 0 WHERE id = :id");
-        updateQuery.bindValue(":id", eventId);
-        if (!updateQuery.exec())
+void AlarmManager::checkAlarms()
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const qint64 graceMs = qint64(m_options.graceSec) * 1000;
+    const qint64 expiryMs = qint64(m_options.expiryMin) * 60 * 1000;
+
+    // The queue is ordered by trigger time, so everything missed while
+    // suspended or stopped is handled here in one pass from the front,
+    // each reminder at most once.
+    QList<QJsonObject> dueEvents;
+    QList<ReminderCompletion> completed;
+    int missedCount = 0;
+    int expiredCount = 0;
+    while (!m_alarmQueue.empty() && m_alarmQueue.begin()->first <= now)
+    {
+        const qint64 triggerMs = m_alarmQueue.begin()->first;
+        ReminderRecord reminder = m_reminders.value(m_alarmQueue.begin()->second);
+        const std::optional<qint64> seenTriggerMs = reminder.triggerMs;
+        removeAlarm(reminder.id);
+
+        std::optional<EventRecord> record = m_activityManager->findRecord(reminder.eventId);
+        if (!record)
         {
-            qWarning() << "❌ Failed to disable reminder for event" << eventId << ":" << updateQuery.lastError().text();
+            continue;
+        }
+
+        // A series reminder stays pending and moves straight to its first
+        // occurrence after now, so occurrences missed during a suspend
+        // collapse into one alarm: the earliest the expiry policy keeps.
+        // A one-off reminder is done.
+        qint64 firedMs = triggerMs;
+        if (reminder.recurring)
+        {
+            if (expiryMs > 0 && now - triggerMs > expiryMs)
+            {
+                std::optional<qint64> kept = record->nextTriggerMs(reminder.offsetMs, now - expiryMs);
+                if (kept && *kept <= now)
+                {
+                    firedMs = *kept;
+                }
+            }
+            reminder.triggerMs = record->nextTriggerMs(reminder.offsetMs, now);
+            reminder.fired = !reminder.triggerMs;
+            if (reminder.triggerMs)
+            {
+                setAlarm(reminder, *reminder.triggerMs);
+            }
         }
         else
         {
-            qInfo() << "✅ Disabled reminder for event" << eventId;
+            reminder.fired = true;
+        }
+        completed.append({reminder, seenTriggerMs});
+
+        QJsonObject event = record->occurrenceForTrigger(reminder.offsetMs, firedMs).toJson();
+        event["reminderId"] = reminder.id;
+        const QString eventId = event["id"].toString();
+
+        const qint64 lateMs = now - firedMs;
+        if (expiryMs > 0 && lateMs > expiryMs)
+        {
+            qInfo() << "⌛ Reminder expired without firing:" << event["title"].toString()
+                    << "ID:" << eventId << "(" << lateMs / 60000 << "min late)";
+            expiredCount++;
+            continue;
         }
 
-        triggeredCount++;
+        if (lateMs > graceMs)
+        {
+            event["missed"] = true;
+            missedCount++;
+        }
+        // Alarms already overdue at startup measure downtime, not timing.
+        else if (firedMs >= m_startedMs)
+        {
+            recordLatency(lateMs);
+        }
+
+        qInfo() << (lateMs > graceMs ? "🔔 MISSED ALARM" : "🔔 ALARM TRIGGERED!") << "Event:" << event["title"].toString()
+                << "Category:" << event["category"].toString() << "ID:" << eventId;
+        dueEvents.append(event);
     }
 
-    if (triggeredCount > 0)
+    if (!completed.isEmpty())
     {
-        qInfo() << "✅ Triggered" << triggeredCount << "alarm(s)";
-        loadActiveAlarms();
+        if (!m_activityManager->completeReminders(completed))
+        {
+            qWarning() << "❌ Failed to update" << completed.size() << "reminder(s)";
+        }
+        else
+        {
+            qInfo() << "✅ Completed" << completed.size() << "reminder(s)";
+        }
+        recordCatchUp(missedCount, expiredCount);
     }
+    if (!dueEvents.isEmpty())
+    {
+        if (dueEvents.size() <= maxIndividualNotifications)
+        {
+            for (const QJsonObject &event : dueEvents)
+            {
+                showNotification(event);
+            }
+        }
+        else
+        {
+            showSummaryNotification(dueEvents, missedCount);
+        }
+
+        for (const QJsonObject &event : dueEvents)
+        {
+            emit alarmTriggered(event["id"].toString(), event["title"].toString());
+        }
+
+        qInfo() << "✅ Triggered" << dueEvents.size() << "alarm(s)," << missedCount << "of them missed";
+    }
+
+    scheduleNextAlarm();
 }
 
 void AlarmManager::onTimerTimeout()
 {
+    // QTimer runs on a monotonic clock that may stop during suspend, while
+    // alarms are wall-clock times. A gap between the two means the machine
+    // slept or the clock was changed.
+    const qint64 wallElapsed = QDateTime::currentMSecsSinceEpoch() - m_armedAtMs;
+    const qint64 drift = wallElapsed - m_armedClock.elapsed();
+    if (std::abs(drift) > clockJumpThresholdMs)
+    {
+        qInfo() << "🕒 Clock jump or resume detected (" << drift << "ms) - catching up on missed alarms";
+    }
+
     checkAlarms();
 }
 
-void AlarmManager::loadActiveAlarms()
+void AlarmManager::onRemindersChanged(const QString &eventId)
 {
-    QSqlQuery query(Database::instance().db());
-    query.prepare(R"(
-        SELECT id, title, reminder_time
-        FROM events
-        WHERE is_reminder_enabled = 1
-        AND reminder_time IS NOT NULL
-        AND datetime(reminder_time) > datetime('now')
-    )");
+    const auto earliest = m_alarmQueue.empty() ? std::pair<qint64, QString>() : *m_alarmQueue.begin();
+    removeEventAlarms(eventId);
 
-    if (!query.exec())
+    const QList<ReminderRecord> reminders = m_activityManager->pendingReminders(eventId);
+    std::optional<EventRecord> series;
+    for (const ReminderRecord &reminder : reminders)
     {
-        qWarning() << "❌ Failed to load active alarms:" << query.lastError().text();
-        return;
+        if (reminder.recurring && !series)
+        {
+            series = m_activityManager->findRecord(eventId);
+        }
+        if (std::optional<qint64> triggerMs = nextTrigger(reminder, series ? &*series : nullptr))
+        {
+            setAlarm(reminder, *triggerMs);
+        }
     }
 
-    m_activeAlarms.clear();
-    int count = 0;
-
-    while (query.next())
+    const auto newEarliest = m_alarmQueue.empty() ? std::pair<qint64, QString>() : *m_alarmQueue.begin();
+    if (newEarliest != earliest)
     {
-        QString id = query.value("id").toString();
-        QString title = query.value("title").toString();
-        QString timeStr = query.value("reminder_time").toString();
-        QDateTime triggerTime = QDateTime::fromString(timeStr, Qt::ISODate);
-
-        if (triggerTime.isValid())
-        {
-            m_activeAlarms[id] = triggerTime;
-            count++;
-        }
+        scheduleNextAlarm();
     }
+}
 
-    qInfo() << "📋 Loaded" << count << "active alarm(s)";
+void AlarmManager::onActivityDeleted(const QString &eventId)
+{
+    if (removeEventAlarms(eventId))
+    {
+        scheduleNextAlarm();
+    }
 }
 
-void AlarmManager::showNotification(const QString &eventId, const QString &title, const QString &category, const QString &startTime)
+bool AlarmManager::setAlarm(const ReminderRecord &reminder, qint64 triggerMs)
 {
-    QString message = QString("Event: %1\nCategory: %2\nTime: %3").arg(title, category, startTime);
+    auto existing = m_triggerById.constFind(reminder.id);
+    if (existing != m_triggerById.constEnd() && existing.value() == triggerMs)
+    {
+        return false;
+    }
 
-    qInfo() << "🔔 ================================";
-    qInfo() << "🔔 ALARM NOTIFICATION";
-    qInfo() << "🔔 Event ID:" << eventId;
-    qInfo() << "🔔 Title:" << title;
-    qInfo() << "🔔 Category:" << category;
-    qInfo() << "🔔 Start Time:" << startTime;
-    qInfo() << "🔔 ================================";
+    const bool wasEmpty = m_alarmQueue.empty();
+    const auto earliest = wasEmpty ? std::pair<qint64, QString>() : *m_alarmQueue.begin();
+    removeAlarm(reminder.id);
+    m_alarmQueue.emplace(triggerMs, reminder.id);
+    m_triggerById.insert(reminder.id, triggerMs);
+    m_reminders.insert(reminder.id, reminder);
+    m_remindersByEvent.insert(reminder.eventId, reminder.id);
+    return wasEmpty || *m_alarmQueue.begin() != earliest;
+}
 
-    // Play alarm sound
-    playAlarmSound();
+bool AlarmManager::removeAlarm(const QString &reminderId)
+{
+    auto it = m_triggerById.find(reminderId);
+    if (it == m_triggerById.end())
+    {
+        return false;
+    }
 
-#if defined(Q_OS_LINUX)
-    // On Linux, always use notify-send (more reliable than QSystemTrayIcon)
-    QProcess::startDetached("notify-send",
-                            QStringList() << "-u" << "critical"
-                                          << "-i" << "appointment-soon"
-                                          << "-t" << "10000" // Show for 10 seconds
-                                          << QString("Daily Reminder: %1").arg(title)
-                                          << message);
-    qInfo() << "✅ Linux notification sent via notify-send";
+    auto entry = m_alarmQueue.find({it.value(), reminderId});
+    bool wasFirst = entry == m_alarmQueue.begin();
+    m_alarmQueue.erase(entry);
+    m_triggerById.erase(it);
+    m_remindersByEvent.remove(m_reminders.take(reminderId).eventId, reminderId);
+    return wasFirst;
+}
 
-#elif defined(Q_OS_MACOS)
-    QString script = QString("display notification \"%1\" with title \"Daily Reminder: %2\" sound name \"default\"")
-                         .arg(message.replace("\"", "\\\""), title.replace("\"", "\\\""));
-    QProcess::startDetached("osascript", QStringList() << "-e" << script);
-    qInfo() << "✅ macOS notification sent via osascript";
+bool AlarmManager::removeEventAlarms(const QString &eventId)
+{
+    bool changed = false;
+    for (const QString &reminderId : m_remindersByEvent.values(eventId))
+    {
+        changed = removeAlarm(reminderId) || changed;
+    }
+    return changed;
+}
 
-#elif defined(Q_OS_WIN)
-    // On Windows, use QSystemTrayIcon
-    if (m_trayIcon && m_trayIcon->isVisible() && m_trayIcon->supportsMessages())
+std::optional<qint64> AlarmManager::nextTrigger(const ReminderRecord &reminder, const EventRecord *series) const
+{
+    if (!reminder.recurring)
     {
-        m_trayIcon->showMessage(
-            QString("Daily Reminder: %1").arg(title),
-            message,
-            QSystemTrayIcon::Information,
-            10000 // Show for 10 seconds
-        );
-        qInfo() << "✅ Windows notification sent via system tray";
+        return reminder.triggerMs;
     }
-    else
+    if (!series)
     {
-        qWarning() << "⚠️ System tray not available on Windows";
+        return std::nullopt;
     }
-#endif
 
-// Also show in system tray as backup (if available and not already shown)
-#if !defined(Q_OS_WIN)
-    if (m_trayIcon && m_trayIcon->isVisible() && m_trayIcon->supportsMessages())
+    // A series resumes at its stored trigger, but never replays occurrences
+    // the expiry policy would drop anyway. Without a stored trigger (new or
+    // rescheduled series) it starts from the grace window, not its first
+    // occurrence.
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    qint64 afterMs = now - qint64(m_options.graceSec) * 1000;
+    if (reminder.triggerMs)
     {
-        m_trayIcon->showMessage(
-            QString("Daily Reminder: %1").arg(title),
-            message,
-            QSystemTrayIcon::Information,
-            10000);
+        afterMs = *reminder.triggerMs - 1;
+        if (m_options.expiryMin > 0)
+        {
+            afterMs = std::max(afterMs, now - qint64(m_options.expiryMin) * 60 * 1000);
+        }
     }
-#endif
+    return series->nextTriggerMs(reminder.offsetMs, afterMs);
 }
 
-void AlarmManager::playAlarmSound()
+void AlarmManager::loadActiveAlarms()
 {
-#if defined(Q_OS_LINUX)
-    // Try multiple sound files in order of preference
-    QStringList soundFiles = {
-        "/usr/share/sounds/freedesktop/stereo/alarm-clock-elapsed.oga",
-        "/usr/share/sounds/freedesktop/stereo/complete.oga",
-        "/usr/share/sounds/freedesktop/stereo/bell.oga",
-        "/usr/share/sounds/sound-icons/xylofon.wav"};
+    // Only the pending rows of the reminders trigger index are read.
+    // Overdue one-off reminders are loaded too so they fire on the first
+    // timeout; each series reminder contributes only its next occurrence.
+    const QList<ReminderRecord> reminders = m_activityManager->pendingReminders();
 
-    for (const QString &soundFile : soundFiles)
+    m_alarmQueue.clear();
+    m_triggerById.clear();
+    m_reminders.clear();
+    m_remindersByEvent.clear();
+
+    for (const ReminderRecord &reminder : reminders)
     {
-        if (QFile::exists(soundFile))
+        std::optional<EventRecord> series;
+        if (reminder.recurring)
         {
-            // Try paplay first (PulseAudio)
-            if (QProcess::startDetached("paplay", QStringList() << soundFile))
-            {
-                qInfo() << "🔊 Playing alarm sound:" << soundFile;
-                return;
-            }
-            // Fallback to aplay (ALSA)
-            if (QProcess::startDetached("aplay", QStringList() << soundFile))
-            {
-                qInfo() << "🔊 Playing alarm sound:" << soundFile;
-                return;
-            }
+            series = m_activityManager->findRecord(reminder.eventId);
+        }
+        if (std::optional<qint64> triggerMs = nextTrigger(reminder, series ? &*series : nullptr))
+        {
+            setAlarm(reminder, *triggerMs);
         }
     }
 
-    // Last resort: system beep
-    QProcess::startDetached("beep", QStringList() << "-f" << "1000" << "-l" << "500" << "-r" << "3");
-    qInfo() << "🔊 Using system beep";
+    qInfo() << "📋 Loaded" << m_triggerById.size() << "active alarm(s)";
+    scheduleNextAlarm();
+}
 
-#elif defined(Q_OS_MACOS)
-    QProcess::startDetached("afplay", QStringList() << "/System/Library/Sounds/Glass.aiff");
-    qInfo() << "🔊 Playing macOS system sound";
+void AlarmManager::scheduleNextAlarm()
+{
+    if (m_alarmQueue.empty())
+    {
+        m_checkTimer->stop();
+        return;
+    }
+
+    // The watchdog cap bounds how late an alarm can fire after a suspend
+    // or clock change that the monotonic timer cannot see.
+    const qint64 maxDelay = m_options.watchdogSec > 0 ? std::min<qint64>(qint64(m_options.watchdogSec) * 1000, maxTimerIntervalMs)
+                                                      : maxTimerIntervalMs;
+    m_armedAtMs = QDateTime::currentMSecsSinceEpoch();
+    m_armedClock.start();
+
+    const qint64 delay = std::clamp<qint64>(m_alarmQueue.begin()->first - m_armedAtMs, 0, maxDelay);
+    m_checkTimer->start(static_cast<int>(delay));
+}
+
+void AlarmManager::showNotification(const QJsonObject &event)
+{
+    const QString title = event["title"].toString();
+    Notification notification;
+    notification.eventId = event["id"].toString();
+    notification.heading = QString(event["missed"].toBool() ? "Missed Reminder: %1" : "Daily Reminder: %1").arg(title);
+    notification.message = QString("Event: %1\nCategory: %2\nTime: %3")
+                               .arg(title, event["category"].toString(), event["startDate"].toString());
+    notification.firedAt = QDateTime::currentDateTime();
+    m_notifier->post(notification);
+}
 
-#elif defined(Q_OS_WIN)
-    // Windows: Play system sound
-    QProcess::startDetached("powershell", QStringList() << "-Command" << "[console]::beep(1000,500)");
-    qInfo() << "🔊 Playing Windows beep";
-#endif
-}
\ No newline at end of file
+void AlarmManager::showSummaryNotification(const QList<QJsonObject> &events, int missedCount)
+{
+    QStringList lines;
+    for (int i = 0; i < events.size() && i < maxIndividualNotifications; ++i)
+    {
+        lines << QString("%1 (%2)").arg(events[i]["title"].toString(), events[i]["startDate"].toString());
+    }
+    if (events.size() > maxIndividualNotifications)
+    {
+        lines << QString("...and %1 more").arg(events.size() - maxIndividualNotifications);
+    }
+
+    Notification notification;
+    notification.heading = missedCount > 0
+                               ? QString("Daily Reminder: %1 reminders due (%2 missed)").arg(events.size()).arg(missedCount)
+                               : QString("Daily Reminder: %1 reminders due").arg(events.size());
+    notification.message = lines.join("\n");
+    notification.firedAt = QDateTime::currentDateTime();
+    m_notifier->post(notification);
+}
@@ -5,34 +5,103 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QTimer>
-#include <QMap>
-#include <QSystemTrayIcon>
+#include <QHash>
+#include <QMultiHash>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <optional>
+#include <set>
+#include <utility>
+#include "activitymanager.h"
+
+class NotificationDispatcher;
+class QThread;
 
 class AlarmManager : public QObject
 {
     Q_OBJECT
 
 public:
-    explicit AlarmManager(QObject *parent = nullptr);
-    void setSystemTrayIcon(QSystemTrayIcon *trayIcon);
+    // Catch-up policy for alarms that come due late (after suspend, a clock
+    // change or downtime). Alarms late by at most graceSec fire normally;
+    // later ones are shown as missed, and those older than expiryMin are
+    // dropped silently (0 keeps them forever). watchdogSec caps the timer
+    // interval so a sleep is noticed within that time; it is off (0) by
+    // default because it wakes the thread even when no alarm is near.
+    struct Options
+    {
+        int graceSec = 60;
+        int expiryMin = 24 * 60;
+        int watchdogSec = 0;
+    };
+
+    // The manager has no parent: start() moves it onto its own thread so
+    // alarm timing is not affected by the GUI or HTTP event loop.
+    AlarmManager(ActivityManager *activityManager, NotificationDispatcher *notifier);
+    ~AlarmManager();
+
+    // Call before start().
+    void setOptions(const Options &options);
+    void start();
+    void stop();
+
+    // Firing latency (actual minus scheduled time) of alarms fired on time
+    // since start(), plus missed/expired counts. Thread-safe.
+    QJsonObject latencyStats() const;
 
     void checkAlarms();
-    void reloadAlarms();
 
 signals:
     void alarmTriggered(const QString &eventId, const QString &title);
 
 private slots:
     void onTimerTimeout();
+    void onRemindersChanged(const QString &eventId);
+    void onActivityDeleted(const QString &eventId);
 
 private:
+    ActivityManager *m_activityManager;
+    NotificationDispatcher *m_notifier;
+    // Single-shot timer armed for the earliest entry in m_alarmQueue.
     QTimer *m_checkTimer;
-    QMap<QString, QDateTime> m_activeAlarms;
-    QSystemTrayIcon *m_trayIcon;
+    // Wall-clock and monotonic time when the timer was last armed.
+    qint64 m_armedAtMs;
+    QElapsedTimer m_armedClock;
+    // Pending reminders ordered by (trigger ms, reminder id); m_triggerById
+    // maps each reminder back to its queue entry so it can be found and
+    // removed. m_reminders and m_remindersByEvent hold what firing needs.
+    std::set<std::pair<qint64, QString>> m_alarmQueue;
+    QHash<QString, qint64> m_triggerById;
+    QHash<QString, ReminderRecord> m_reminders;
+    QMultiHash<QString, QString> m_remindersByEvent;
 
     void loadActiveAlarms();
-    void showNotification(const QString &eventId, const QString &title, const QString &category, const QString &startTime);
-    void playAlarmSound();
+    std::optional<qint64> nextTrigger(const ReminderRecord &reminder, const EventRecord *series) const;
+    void scheduleNextAlarm();
+    // Index updates; all return true when the earliest alarm changed.
+    bool setAlarm(const ReminderRecord &reminder, qint64 triggerMs);
+    bool removeAlarm(const QString &reminderId);
+    bool removeEventAlarms(const QString &eventId);
+    void showNotification(const QJsonObject &event);
+    void showSummaryNotification(const QList<QJsonObject> &events, int missedCount);
+    void recordLatency(qint64 latencyMs);
+    void recordCatchUp(int missed, int expired);
+
+    struct LatencyStats
+    {
+        qint64 count = 0;
+        qint64 lastMs = 0;
+        qint64 maxMs = 0;
+        qint64 totalMs = 0;
+        qint64 missed = 0;
+        qint64 expired = 0;
+    };
+
+    Options m_options;
+    QThread *m_thread;
+    qint64 m_startedMs;
+    mutable QMutex m_statsMutex;
+    LatencyStats m_latency;
 };
 
 #endif
\ No newline at end of file
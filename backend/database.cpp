@@ -1,9 +1,328 @@
 #include "database.h"
 #include <QSqlQuery>
 #include <QSqlError>
+#include <QStringList>
+#include <QDateTime>
 #include <QStandardPaths>
 #include <QDir>
+#include <QThreadStorage>
 #include <QDebug>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+
+namespace
+{
+    // Schema changes are appended here and never edited once released.
+    // Each migration runs once, in order, inside its own transaction.
+    // Statements run first, then the optional apply step for data changes
+    // that need to happen in C++.
+    struct Migration
+    {
+        int version;
+        const char *description;
+        QStringList statements;
+        std::function<bool(QSqlDatabase &)> apply = nullptr;
+    };
+
+    bool backfillEpochColumns(QSqlDatabase &db)
+    {
+        QSqlQuery select(db);
+        if (!select.exec("SELECT id, start_date, end_date, reminder_time FROM events"))
+        {
+            qDebug() << "ERROR reading events for epoch backfill:" << select.lastError().text();
+            return false;
+        }
+
+        QSqlQuery update(db);
+        update.prepare("UPDATE events SET start_ms = :start_ms, end_ms = :end_ms, reminder_ms = :reminder_ms WHERE id = :id");
+
+        while (select.next())
+        {
+            update.bindValue(":id", select.value(0));
+            update.bindValue(":start_ms", Database::toEpochMs(select.value(1).toString()));
+            update.bindValue(":end_ms", Database::toEpochMs(select.value(2).toString()));
+            update.bindValue(":reminder_ms", Database::toEpochMs(select.value(3).toString()));
+            if (!update.exec())
+            {
+                qDebug() << "ERROR backfilling epoch columns:" << update.lastError().text();
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // R*Tree over [start_ms, end_ms] keyed by the events rowid, kept in sync by
+    // triggers. Coordinates are 32-bit floats rounded outward, so the tree is
+    // a coarse filter and queries re-check the exact epoch columns. Skipped
+    // when SQLite is built without the rtree module; range queries then fall
+    // back to the start/end indexes. Superseded by migration 8, as the
+    // events rowid is not an INTEGER PRIMARY KEY alias and VACUUM may
+    // renumber it.
+    bool createIntervalIndex(QSqlDatabase &db)
+    {
+        QSqlQuery query(db);
+        if (!query.exec("CREATE VIRTUAL TABLE IF NOT EXISTS events_rtree USING rtree(id, min_ms, max_ms)"))
+        {
+            qDebug() << "R*Tree module unavailable, range queries will use B-tree indexes:" << query.lastError().text();
+            return true;
+        }
+
+        const QStringList statements = {
+            R"(INSERT INTO events_rtree (id, min_ms, max_ms)
+               SELECT rowid, MIN(start_ms, end_ms), MAX(start_ms, end_ms) FROM events
+               WHERE start_ms IS NOT NULL AND end_ms IS NOT NULL)",
+            R"(CREATE TRIGGER IF NOT EXISTS events_rtree_insert AFTER INSERT ON events
+               WHEN new.start_ms IS NOT NULL AND new.end_ms IS NOT NULL
+               BEGIN
+                   INSERT INTO events_rtree (id, min_ms, max_ms)
+                   VALUES (new.rowid, MIN(new.start_ms, new.end_ms), MAX(new.start_ms, new.end_ms));
+               END)",
+            R"(CREATE TRIGGER IF NOT EXISTS events_rtree_update AFTER UPDATE OF start_ms, end_ms ON events
+               BEGIN
+                   DELETE FROM events_rtree WHERE id = old.rowid;
+                   INSERT INTO events_rtree (id, min_ms, max_ms)
+                   SELECT new.rowid, MIN(new.start_ms, new.end_ms), MAX(new.start_ms, new.end_ms)
+                   WHERE new.start_ms IS NOT NULL AND new.end_ms IS NOT NULL;
+               END)",
+            R"(CREATE TRIGGER IF NOT EXISTS events_rtree_delete AFTER DELETE ON events
+               BEGIN
+                   DELETE FROM events_rtree WHERE id = old.rowid;
+               END)"};
+
+        for (const QString &statement : statements)
+        {
+            if (!query.exec(statement))
+            {
+                qDebug() << "ERROR creating interval index:" << query.lastError().text();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Replaces migration 3's tree, which was keyed by the events rowid: with
+    // a TEXT primary key that rowid is not stable and VACUUM may renumber
+    // it, silently pairing boxes with the wrong events. The event id is now
+    // an auxiliary column of the tree. Rows are found again for update and
+    // delete through the tree's own spatial index (the old interval
+    // overlaps its stored, outward-rounded box), so no scan is needed.
+    bool rekeyIntervalIndex(QSqlDatabase &db)
+    {
+        QSqlQuery query(db);
+        if (!query.exec("SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = 'events_rtree'") || !query.next())
+        {
+            return true;
+        }
+        query.finish();
+
+        const QStringList dropStatements = {
+            "DROP TRIGGER IF EXISTS events_rtree_insert",
+            "DROP TRIGGER IF EXISTS events_rtree_update",
+            "DROP TRIGGER IF EXISTS events_rtree_delete",
+            "DROP TABLE events_rtree"};
+        for (const QString &statement : dropStatements)
+        {
+            if (!query.exec(statement))
+            {
+                qDebug() << "ERROR dropping rowid interval index:" << query.lastError().text();
+                return false;
+            }
+        }
+
+        if (!query.exec("CREATE VIRTUAL TABLE events_rtree USING rtree(id, min_ms, max_ms, +event_id TEXT)"))
+        {
+            qDebug() << "R*Tree auxiliary columns unavailable, range queries will use B-tree indexes:" << query.lastError().text();
+            return true;
+        }
+
+        const QStringList statements = {
+            R"(INSERT INTO events_rtree (min_ms, max_ms, event_id)
+               SELECT MIN(start_ms, end_ms), MAX(start_ms, end_ms), id FROM events
+               WHERE start_ms IS NOT NULL AND end_ms IS NOT NULL)",
+            R"(CREATE TRIGGER IF NOT EXISTS events_rtree_insert AFTER INSERT ON events
+               WHEN new.start_ms IS NOT NULL AND new.end_ms IS NOT NULL
+               BEGIN
+                   INSERT INTO events_rtree (min_ms, max_ms, event_id)
+                   VALUES (MIN(new.start_ms, new.end_ms), MAX(new.start_ms, new.end_ms), new.id);
+               END)",
+            R"(CREATE TRIGGER IF NOT EXISTS events_rtree_update AFTER UPDATE OF start_ms, end_ms ON events
+               BEGIN
+                   DELETE FROM events_rtree
+                   WHERE min_ms <= MAX(old.start_ms, old.end_ms) AND max_ms >= MIN(old.start_ms, old.end_ms)
+                   AND event_id = old.id;
+                   INSERT INTO events_rtree (min_ms, max_ms, event_id)
+                   SELECT MIN(new.start_ms, new.end_ms), MAX(new.start_ms, new.end_ms), new.id
+                   WHERE new.start_ms IS NOT NULL AND new.end_ms IS NOT NULL;
+               END)",
+            R"(CREATE TRIGGER IF NOT EXISTS events_rtree_delete AFTER DELETE ON events
+               BEGIN
+                   DELETE FROM events_rtree
+                   WHERE min_ms <= MAX(old.start_ms, old.end_ms) AND max_ms >= MIN(old.start_ms, old.end_ms)
+                   AND event_id = old.id;
+               END)"};
+
+        for (const QString &statement : statements)
+        {
+            if (!query.exec(statement))
+            {
+                qDebug() << "ERROR creating interval index:" << query.lastError().text();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const QList<Migration> &migrations()
+    {
+        static const QList<Migration> list = {
+            {1, "Index event date range and reminder columns",
+             {"CREATE INDEX IF NOT EXISTS idx_events_start_date ON events(start_date)",
+              "CREATE INDEX IF NOT EXISTS idx_events_end_date ON events(end_date)",
+              "CREATE INDEX IF NOT EXISTS idx_events_reminder_time ON events(reminder_time) WHERE is_reminder_enabled = 1"}},
+            {2, "Add UTC epoch millisecond shadow columns",
+             {"ALTER TABLE events ADD COLUMN start_ms INTEGER",
+              "ALTER TABLE events ADD COLUMN end_ms INTEGER",
+              "ALTER TABLE events ADD COLUMN reminder_ms INTEGER",
+              "DROP INDEX IF EXISTS idx_events_start_date",
+              "DROP INDEX IF EXISTS idx_events_end_date",
+              "DROP INDEX IF EXISTS idx_events_reminder_time",
+              "CREATE INDEX IF NOT EXISTS idx_events_start_ms ON events(start_ms)",
+              "CREATE INDEX IF NOT EXISTS idx_events_end_ms ON events(end_ms)",
+              "CREATE INDEX IF NOT EXISTS idx_events_reminder_ms ON events(reminder_ms) WHERE is_reminder_enabled = 1"},
+             backfillEpochColumns},
+            {3, "Add R*Tree interval index over event time ranges", {}, createIntervalIndex},
+            {4, "Index (start_ms, id) for keyset pagination",
+             {"CREATE INDEX IF NOT EXISTS idx_events_start_ms_id ON events(start_ms, id)",
+              "DROP INDEX IF EXISTS idx_events_start_ms"}},
+            {5, "Add recurrence rule, exceptions and series bounds",
+             {"ALTER TABLE events ADD COLUMN recurrence_rule TEXT",
+              "ALTER TABLE events ADD COLUMN recurrence_exceptions TEXT",
+              "ALTER TABLE events ADD COLUMN recurrence_end_ms INTEGER",
+              "ALTER TABLE events ADD COLUMN last_fired_ms INTEGER",
+              "CREATE INDEX IF NOT EXISTS idx_events_recurring ON events(start_ms, recurrence_end_ms) WHERE recurrence_rule IS NOT NULL"}},
+            // Reminders get their own table so an event can have several and
+            // the scheduler reads pending ones off idx_reminders_trigger_ms.
+            // An event's reminder_time/is_reminder_enabled pair is mirrored
+            // by triggers into its "<id>:default" row. trigger_ms is the
+            // exact trigger for one-off events; for a series it is the lower
+            // bound of the next trigger, NULL meaning "from now on", which
+            // supersedes events.last_fired_ms.
+            {6, "Move reminders into their own table indexed by trigger time",
+             {R"(CREATE TABLE IF NOT EXISTS reminders (
+                     id TEXT PRIMARY KEY,
+                     event_id TEXT NOT NULL,
+                     offset_ms INTEGER NOT NULL,
+                     trigger_ms INTEGER,
+                     fired INTEGER NOT NULL DEFAULT 0
+                 ))",
+              "CREATE INDEX IF NOT EXISTS idx_reminders_trigger_ms ON reminders(trigger_ms) WHERE fired = 0",
+              "CREATE INDEX IF NOT EXISTS idx_reminders_event_id ON reminders(event_id)",
+              R"(INSERT OR IGNORE INTO reminders (id, event_id, offset_ms, trigger_ms, fired)
+                 SELECT id || ':default', id, start_ms - reminder_ms,
+                        CASE WHEN recurrence_rule IS NULL THEN reminder_ms ELSE last_fired_ms + 1 END,
+                        is_reminder_enabled = 0
+                 FROM events WHERE start_ms IS NOT NULL AND reminder_ms IS NOT NULL)",
+              R"(CREATE TRIGGER IF NOT EXISTS events_reminders_insert AFTER INSERT ON events
+                 WHEN new.start_ms IS NOT NULL AND new.reminder_ms IS NOT NULL
+                 BEGIN
+                     INSERT OR REPLACE INTO reminders (id, event_id, offset_ms, trigger_ms, fired)
+                     VALUES (new.id || ':default', new.id, new.start_ms - new.reminder_ms,
+                             CASE WHEN new.recurrence_rule IS NULL THEN new.reminder_ms END,
+                             new.is_reminder_enabled = 0);
+                 END)",
+              R"(CREATE TRIGGER IF NOT EXISTS events_reminders_update
+                 AFTER UPDATE OF start_ms, reminder_ms, is_reminder_enabled, recurrence_rule ON events
+                 WHEN new.start_ms IS NOT old.start_ms OR new.reminder_ms IS NOT old.reminder_ms
+                   OR new.is_reminder_enabled IS NOT old.is_reminder_enabled
+                   OR new.recurrence_rule IS NOT old.recurrence_rule
+                 BEGIN
+                     DELETE FROM reminders WHERE id = new.id || ':default';
+                     INSERT INTO reminders (id, event_id, offset_ms, trigger_ms, fired)
+                     SELECT new.id || ':default', new.id, new.start_ms - new.reminder_ms,
+                            CASE WHEN new.recurrence_rule IS NULL THEN new.reminder_ms END,
+                            new.is_reminder_enabled = 0
+                     WHERE new.start_ms IS NOT NULL AND new.reminder_ms IS NOT NULL;
+                     UPDATE reminders
+                     SET trigger_ms = CASE WHEN new.recurrence_rule IS NULL THEN new.start_ms - offset_ms END,
+                         fired = new.recurrence_rule IS NULL
+                                 AND new.start_ms - offset_ms < CAST(strftime('%s', 'now') AS INTEGER) * 1000
+                     WHERE event_id = new.id AND id <> new.id || ':default'
+                       AND (new.start_ms IS NOT old.start_ms OR new.recurrence_rule IS NOT old.recurrence_rule);
+                 END)",
+              R"(CREATE TRIGGER IF NOT EXISTS events_reminders_delete AFTER DELETE ON events
+                 BEGIN
+                     DELETE FROM reminders WHERE event_id = old.id;
+                 END)",
+              "DROP INDEX IF EXISTS idx_events_reminder_ms"}},
+            // Change log for delta sync, written by triggers so every write
+            // to events appends in its own transaction. event_id is unique
+            // and rows are replaced, which keeps one row per event: the log
+            // compacts itself and only old tombstones need purging.
+            // sync_state holds the revision tombstones were purged through.
+            {7, "Add change log for delta sync",
+             {R"(CREATE TABLE IF NOT EXISTS changes (
+                     revision INTEGER PRIMARY KEY AUTOINCREMENT,
+                     event_id TEXT NOT NULL UNIQUE,
+                     deleted INTEGER NOT NULL DEFAULT 0,
+                     changed_ms INTEGER NOT NULL
+                 ))",
+              R"(CREATE TABLE IF NOT EXISTS sync_state (
+                     key TEXT PRIMARY KEY,
+                     value INTEGER NOT NULL
+                 ))",
+              R"(INSERT OR REPLACE INTO changes (event_id, deleted, changed_ms)
+                 SELECT id, 0, CAST(strftime('%s', 'now') AS INTEGER) * 1000 FROM events
+                 ORDER BY start_ms)",
+              R"(CREATE TRIGGER IF NOT EXISTS events_changes_insert AFTER INSERT ON events
+                 BEGIN
+                     INSERT OR REPLACE INTO changes (event_id, deleted, changed_ms)
+                     VALUES (new.id, 0, CAST(strftime('%s', 'now') AS INTEGER) * 1000);
+                 END)",
+              R"(CREATE TRIGGER IF NOT EXISTS events_changes_update AFTER UPDATE ON events
+                 BEGIN
+                     INSERT OR REPLACE INTO changes (event_id, deleted, changed_ms)
+                     VALUES (new.id, 0, CAST(strftime('%s', 'now') AS INTEGER) * 1000);
+                 END)",
+              R"(CREATE TRIGGER IF NOT EXISTS events_changes_delete AFTER DELETE ON events
+                 BEGIN
+                     INSERT OR REPLACE INTO changes (event_id, deleted, changed_ms)
+                     VALUES (old.id, 1, CAST(strftime('%s', 'now') AS INTEGER) * 1000);
+                 END)"}},
+            {8, "Key the R*Tree interval index by event id instead of rowid", {}, rekeyIntervalIndex},
+        };
+        return list;
+    }
+}
+
+namespace
+{
+    struct CachedStatement
+    {
+        explicit CachedStatement(const QSqlDatabase &database) : query(database) {}
+
+        QSqlQuery query;
+        bool prepared = false;
+    };
+
+    // Owns one thread's connection name and statement cache; QThreadStorage
+    // deletes it when the thread exits, which releases the connection from
+    // that same thread.
+    struct ThreadConnection
+    {
+        QString name;
+        std::unordered_map<QString, std::unique_ptr<CachedStatement>> statements;
+
+        ~ThreadConnection()
+        {
+            statements.clear();
+            QSqlDatabase::removeDatabase(name);
+        }
+    };
+
+    QThreadStorage<ThreadConnection *> threadConnections;
+}
 
 Database &Database::instance()
 {
@@ -13,15 +332,102 @@ Database &Database::instance()
 
 Database::Database()
 {
-    m_db = QSqlDatabase::addDatabase("QSQLITE");
 }
 
 Database::~Database()
 {
-    if (m_db.isOpen())
+}
+
+QSqlDatabase Database::db()
+{
+    if (m_path.isEmpty())
+    {
+        qDebug() << "ERROR: Database used before initialize()";
+        return QSqlDatabase();
+    }
+
+    if (!threadConnections.hasLocalData())
+    {
+        QString name = QString("daily-reminder-%1").arg(m_connectionCounter.fetchAndAddRelaxed(1));
+        QSqlDatabase database = QSqlDatabase::addDatabase("QSQLITE", name);
+        database.setDatabaseName(m_path);
+        threadConnections.setLocalData(new ThreadConnection{name});
+
+        if (!database.open())
+        {
+            qDebug() << "ERROR: Failed to open database connection" << name << ":" << database.lastError().text();
+        }
+        else
+        {
+            applyPragmas(database);
+        }
+        return database;
+    }
+
+    return QSqlDatabase::database(threadConnections.localData()->name, false);
+}
+
+PreparedQuery Database::prepare(const QString &key, const QString &sql)
+{
+    QSqlDatabase database = db();
+    ThreadConnection *connection = threadConnections.localData();
+    if (!connection)
+    {
+        // Not initialized yet: hand out a statement that fails on exec().
+        static thread_local CachedStatement unavailable{QSqlDatabase()};
+        return PreparedQuery(&unavailable.query);
+    }
+
+    std::unique_ptr<CachedStatement> &entry = connection->statements[key];
+    if (!entry)
+    {
+        entry = std::make_unique<CachedStatement>(database);
+    }
+
+    if (entry->prepared)
+    {
+        m_statementHits.fetchAndAddRelaxed(1);
+        return PreparedQuery(&entry->query);
+    }
+
+    m_statementMisses.fetchAndAddRelaxed(1);
+    entry->query.setForwardOnly(true);
+    entry->prepared = entry->query.prepare(sql);
+    if (!entry->prepared)
+    {
+        qDebug() << "ERROR preparing statement" << key << ":" << entry->query.lastError().text();
+    }
+    return PreparedQuery(&entry->query);
+}
+
+bool Database::applyPragmas(QSqlDatabase &database)
+{
+    static const QStringList synchronousModes = {"OFF", "NORMAL", "FULL", "EXTRA"};
+    QString synchronous = m_options.synchronous.toUpper();
+    if (!synchronousModes.contains(synchronous))
     {
-        m_db.close();
+        qDebug() << "Unknown synchronous mode" << m_options.synchronous << "- using NORMAL";
+        synchronous = "NORMAL";
     }
+
+    // Negative cache_size is in KiB rather than pages.
+    const QStringList pragmas = {
+        "PRAGMA journal_mode = WAL",
+        QString("PRAGMA synchronous = %1").arg(synchronous),
+        QString("PRAGMA cache_size = %1").arg(-qMax(0, m_options.cacheSizeMb) * 1024),
+        QString("PRAGMA mmap_size = %1").arg(qint64(qMax(0, m_options.mmapSizeMb)) * 1024 * 1024),
+        QString("PRAGMA busy_timeout = %1").arg(qMax(0, m_options.busyTimeoutMs))};
+
+    QSqlQuery query(database);
+    for (const QString &pragma : pragmas)
+    {
+        if (!query.exec(pragma))
+        {
+            qDebug() << "ERROR applying" << pragma << ":" << query.lastError().text();
+            return false;
+        }
+    }
+    return true;
 }
 
 bool Database::initialize()
@@ -33,24 +439,50 @@ bool Database::initialize()
         dir.mkpath(dataDir);
     }
 
-    QString dbPath = dataDir + "/activities.db";
-    m_db.setDatabaseName(dbPath);
+    m_path = dataDir + "/activities.db";
 
-    qDebug() << "Database path:" << dbPath;
+    qDebug() << "Database path:" << m_path;
 
-    if (!m_db.open())
+    QSqlDatabase database = db();
+    if (!database.isOpen())
     {
-        qDebug() << "ERROR: Failed to open database:" << m_db.lastError().text();
+        qDebug() << "ERROR: Failed to open database:" << database.lastError().text();
         return false;
     }
 
     qDebug() << "Database opened successfully";
-    return createTables();
+    return createTables() && runMigrations();
+}
+
+QVariant Database::toEpochMs(const QString &isoDateTime)
+{
+    QDateTime dateTime = parseDateTime(isoDateTime);
+    if (!dateTime.isValid())
+    {
+        return QVariant(QMetaType::fromType<qlonglong>());
+    }
+
+    return QVariant(qlonglong(dateTime.toMSecsSinceEpoch()));
+}
+
+QDateTime Database::parseDateTime(const QString &isoDateTime)
+{
+    if (isoDateTime.isEmpty())
+    {
+        return QDateTime();
+    }
+
+    QDateTime dateTime = QDateTime::fromString(isoDateTime, Qt::ISODateWithMs);
+    if (!dateTime.isValid())
+    {
+        dateTime = QDateTime::fromString(isoDateTime, Qt::ISODate);
+    }
+    return dateTime;
 }
 
 bool Database::createTables()
 {
-    QSqlQuery query(m_db);
+    QSqlQuery query(db());
 
     QString createEvents = R"(
         CREATE TABLE IF NOT EXISTS events (
@@ -74,4 +506,93 @@ bool Database::createTables()
 
     qDebug() << "Database tables created successfully";
     return true;
+}
+
+bool Database::runMigrations()
+{
+    QSqlDatabase database = db();
+    QSqlQuery query(database);
+
+    QString createSchemaVersion = R"(
+        CREATE TABLE IF NOT EXISTS schema_version (
+            version INTEGER PRIMARY KEY,
+            description TEXT NOT NULL,
+            applied_at TEXT NOT NULL
+        )
+    )";
+
+    if (!query.exec(createSchemaVersion))
+    {
+        qDebug() << "ERROR creating schema_version table:" << query.lastError().text();
+        return false;
+    }
+
+    if (!query.exec("SELECT COALESCE(MAX(version), 0) FROM schema_version") || !query.next())
+    {
+        qDebug() << "ERROR reading schema version:" << query.lastError().text();
+        return false;
+    }
+    m_schemaVersion = query.value(0).toInt();
+    query.finish();
+
+    for (const Migration &migration : migrations())
+    {
+        if (migration.version <= m_schemaVersion)
+        {
+            continue;
+        }
+
+        if (!database.transaction())
+        {
+            qDebug() << "ERROR starting migration" << migration.version << ":" << database.lastError().text();
+            return false;
+        }
+
+        bool ok = true;
+        for (const QString &statement : migration.statements)
+        {
+            if (!query.exec(statement))
+            {
+                qDebug() << "ERROR in migration" << migration.version << ":" << query.lastError().text();
+                ok = false;
+                break;
+            }
+        }
+
+        if (ok && migration.apply)
+        {
+            ok = migration.apply(database);
+        }
+
+        if (ok)
+        {
+            query.prepare("INSERT INTO schema_version (version, description, applied_at) VALUES (:version, :description, :applied_at)");
+            query.bindValue(":version", migration.version);
+            query.bindValue(":description", QString::fromUtf8(migration.description));
+            query.bindValue(":applied_at", QDateTime::currentDateTimeUtc().toString(Qt::ISODate));
+            ok = query.exec();
+            if (!ok)
+            {
+                qDebug() << "ERROR recording migration" << migration.version << ":" << query.lastError().text();
+            }
+        }
+
+        if (!ok || !database.commit())
+        {
+            database.rollback();
+            return false;
+        }
+
+        m_schemaVersion = migration.version;
+        qDebug() << "Applied migration" << migration.version << "-" << migration.description;
+    }
+
+    if (query.exec("SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = 'events_rtree'"))
+    {
+        m_hasIntervalIndex = query.next();
+        query.finish();
+    }
+
+    qDebug() << "Database schema at version" << m_schemaVersion << (m_hasIntervalIndex ? "(R*Tree interval index)" : "");
+    return true;
 }
\ No newline at end of file
@@ -3,13 +3,67 @@
 
 #include <QSqlDatabase>
 #include <QString>
+#include <QVariant>
+#include <QDateTime>
+#include <QAtomicInt>
+#include <QAtomicInteger>
+#include <QSqlQuery>
+
+// Handle to a cached prepared statement on the calling thread's connection.
+// The statement is reset when the handle goes out of scope so it never keeps
+// a read transaction open between calls. Do not hold two handles with the
+// same key at once.
+class PreparedQuery
+{
+public:
+    explicit PreparedQuery(QSqlQuery *query) : m_query(query) {}
+    ~PreparedQuery() { m_query->finish(); }
+    PreparedQuery(const PreparedQuery &) = delete;
+    PreparedQuery &operator=(const PreparedQuery &) = delete;
+
+    QSqlQuery &operator*() const { return *m_query; }
+    QSqlQuery *operator->() const { return m_query; }
+
+private:
+    QSqlQuery *m_query;
+};
 
 class Database
 {
 public:
+    // Pragmas applied to every pooled connection. Set before initialize().
+    struct Options
+    {
+        QString synchronous = "NORMAL";
+        int cacheSizeMb = 16;
+        int mmapSizeMb = 64;
+        int busyTimeoutMs = 5000;
+    };
+
     static Database &instance();
+    void setOptions(const Options &options) { m_options = options; }
+    const Options &options() const { return m_options; }
     bool initialize();
-    QSqlDatabase &db() { return m_db; }
+
+    // Returns the calling thread's connection, opening it on first use.
+    // Connections are closed when their thread finishes.
+    QSqlDatabase db();
+    int schemaVersion() const { return m_schemaVersion; }
+    // True when the events_rtree interval index exists and is maintained.
+    bool hasIntervalIndex() const { return m_hasIntervalIndex; }
+
+    // Returns the statement cached under key for this thread's connection,
+    // preparing sql on first use. Cached statements are forward-only.
+    PreparedQuery prepare(const QString &key, const QString &sql);
+    quint64 statementCacheHits() const { return m_statementHits.loadRelaxed(); }
+    quint64 statementCacheMisses() const { return m_statementMisses.loadRelaxed(); }
+
+    // Converts an ISO 8601 date-time to UTC epoch milliseconds. Strings without
+    // an offset are read as local time. Returns a null value when unparsable.
+    static QVariant toEpochMs(const QString &isoDateTime);
+    // Parses an ISO 8601 date-time, keeping its offset (local time when it
+    // has none). Returns an invalid QDateTime when unparsable.
+    static QDateTime parseDateTime(const QString &isoDateTime);
 
 private:
     Database();
@@ -18,8 +72,16 @@ private:
     Database &operator=(const Database &) = delete;
 
     bool createTables();
+    bool runMigrations();
+    bool applyPragmas(QSqlDatabase &database);
 
-    QSqlDatabase m_db;
+    QString m_path;
+    Options m_options;
+    QAtomicInt m_connectionCounter;
+    QAtomicInteger<quint64> m_statementHits;
+    QAtomicInteger<quint64> m_statementMisses;
+    int m_schemaVersion = 0;
+    bool m_hasIntervalIndex = false;
 };
 
 #endif
\ No newline at end of file
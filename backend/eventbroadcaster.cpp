@@ -0,0 +1,153 @@
+#include "eventbroadcaster.h"
+#include "activitymanager.h"
+#include "alarmmanager.h"
+#include <QWebSocket>
+#include <QJsonDocument>
+#include <QTimer>
+#include <QDebug>
+
+EventBroadcaster::EventBroadcaster(ActivityManager *activityMgr, AlarmManager *alarmMgr, QObject *parent)
+    : QObject(parent), m_activityManager(activityMgr)
+{
+    m_changesTimer = new QTimer(this);
+    m_changesTimer->setSingleShot(true);
+    m_changesTimer->setInterval(0);
+    connect(m_changesTimer, &QTimer::timeout, this, &EventBroadcaster::broadcastChanges);
+
+    connect(m_activityManager, &ActivityManager::activityCreated, this, &EventBroadcaster::onActivityChanged);
+    connect(m_activityManager, &ActivityManager::activityUpdated, this, &EventBroadcaster::onActivityChanged);
+    connect(m_activityManager, &ActivityManager::activityDeleted, this, &EventBroadcaster::onActivityChanged);
+    connect(alarmMgr, &AlarmManager::alarmTriggered, this, &EventBroadcaster::onAlarmTriggered);
+}
+
+void EventBroadcaster::setOptions(const Options &options)
+{
+    m_options = options;
+    m_options.maxClients = qMax(1, options.maxClients);
+    m_options.maxInFlightBytes = qMax<qint64>(1024, options.maxInFlightBytes);
+    m_options.maxQueuedMessages = qMax(1, options.maxQueuedMessages);
+}
+
+void EventBroadcaster::addClient(std::unique_ptr<QWebSocket> connection)
+{
+    QWebSocket *socket = connection.release();
+    socket->setParent(this);
+    m_clients.insert(socket, Client());
+
+    connect(socket, &QWebSocket::bytesWritten, this, [this, socket](qint64 bytes)
+            {
+        auto client = m_clients.find(socket);
+        if (client == m_clients.end())
+        {
+            return;
+        }
+        // Frame headers are counted here but not when sending, so clamp.
+        client->inFlightBytes = qMax<qint64>(0, client->inFlightBytes - bytes);
+        flush(socket); });
+
+    // Queued, so a socket that fails while being written to is never
+    // removed from under flush().
+    connect(socket, &QWebSocket::disconnected, this, [this, socket]()
+            {
+        if (m_clients.remove(socket))
+        {
+            qDebug() << "🔌 Event stream client disconnected (" << m_clients.size() << "connected)";
+        }
+        socket->deleteLater(); }, Qt::QueuedConnection);
+
+    qDebug() << "🔌 Event stream client connected (" << m_clients.size() << "connected)";
+
+    // Tells a reconnecting client how far it has to catch up.
+    QJsonObject hello{{"type", "hello"}, {"revision", m_activityManager->dataRevision()}};
+    enqueue(socket, QJsonDocument(hello).toJson(QJsonDocument::Compact), false);
+}
+
+void EventBroadcaster::onActivityChanged()
+{
+    if (!m_clients.isEmpty() && !m_changesTimer->isActive())
+    {
+        m_changesTimer->start();
+    }
+}
+
+void EventBroadcaster::onAlarmTriggered(const QString &eventId, const QString &title)
+{
+    broadcast(QJsonObject{{"type", "alarm"}, {"id", eventId}, {"title", title}});
+}
+
+void EventBroadcaster::broadcastChanges()
+{
+    broadcast(QJsonObject{{"type", "changes"}, {"revision", m_activityManager->dataRevision()}}, true);
+}
+
+void EventBroadcaster::broadcast(const QJsonObject &message, bool isChanges)
+{
+    if (m_clients.isEmpty())
+    {
+        return;
+    }
+
+    const QByteArray payload = QJsonDocument(message).toJson(QJsonDocument::Compact);
+    // Copied: enqueue() may drop a client.
+    const QList<QWebSocket *> sockets = m_clients.keys();
+    for (QWebSocket *socket : sockets)
+    {
+        enqueue(socket, payload, isChanges);
+    }
+}
+
+void EventBroadcaster::enqueue(QWebSocket *socket, const QByteArray &message, bool isChanges)
+{
+    auto client = m_clients.find(socket);
+    if (client == m_clients.end())
+    {
+        return;
+    }
+
+    // A newer revision supersedes one the client has not received yet.
+    if (isChanges && client->queuedChangesAt >= 0)
+    {
+        client->queue[client->queuedChangesAt] = message;
+        return;
+    }
+
+    if (client->queue.size() >= m_options.maxQueuedMessages)
+    {
+        dropClient(socket, "Client is not keeping up");
+        return;
+    }
+
+    if (isChanges)
+    {
+        client->queuedChangesAt = client->queue.size();
+    }
+    client->queue.enqueue(message);
+    flush(socket);
+}
+
+void EventBroadcaster::flush(QWebSocket *socket)
+{
+    auto client = m_clients.find(socket);
+    if (client == m_clients.end())
+    {
+        return;
+    }
+
+    while (!client->queue.isEmpty() && client->inFlightBytes < m_options.maxInFlightBytes)
+    {
+        const QByteArray message = client->queue.dequeue();
+        client->queuedChangesAt = client->queuedChangesAt > 0 ? client->queuedChangesAt - 1 : -1;
+        client->inFlightBytes += socket->sendTextMessage(QString::fromUtf8(message));
+    }
+}
+
+void EventBroadcaster::dropClient(QWebSocket *socket, const QString &reason)
+{
+    if (!m_clients.remove(socket))
+    {
+        return;
+    }
+    qWarning() << "⚠️ Closing event stream client:" << reason;
+    // The disconnected handler deletes the socket once the close completes.
+    socket->close(QWebSocketProtocol::CloseCodePolicyViolated, reason);
+}
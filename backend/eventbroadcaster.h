@@ -0,0 +1,71 @@
+#ifndef EVENTBROADCASTER_H
+#define EVENTBROADCASTER_H
+
+#include <QObject>
+#include <QHash>
+#include <QQueue>
+#include <QByteArray>
+#include <QJsonObject>
+#include <memory>
+
+class ActivityManager;
+class AlarmManager;
+class QWebSocket;
+class QTimer;
+
+// Pushes event changes and alarms to connected WebSocket clients so the UI
+// never has to poll. Change notifications only carry the new data revision:
+// bursts (a batch import, say) collapse into one message, and clients fetch
+// the actual rows from /api/event/changes. Lives on the HTTP server's
+// thread; ActivityManager signals from worker threads arrive queued.
+class EventBroadcaster : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Each client may have maxInFlightBytes handed to its socket but not yet
+    // written out; messages beyond that wait in a queue of maxQueuedMessages.
+    // A client that lets the queue fill is disconnected and resyncs from
+    // its last revision when it reconnects.
+    struct Options
+    {
+        int maxClients = 32;
+        qint64 maxInFlightBytes = 64 * 1024;
+        int maxQueuedMessages = 64;
+    };
+
+    explicit EventBroadcaster(ActivityManager *activityMgr, AlarmManager *alarmMgr, QObject *parent = nullptr);
+    void setOptions(const Options &options);
+
+    bool canAccept() const { return m_clients.size() < m_options.maxClients; }
+    void addClient(std::unique_ptr<QWebSocket> socket);
+
+private slots:
+    void onActivityChanged();
+    void onAlarmTriggered(const QString &eventId, const QString &title);
+
+private:
+    struct Client
+    {
+        QQueue<QByteArray> queue;
+        qint64 inFlightBytes = 0;
+        // Position of a queued "changes" message, replaced in place by
+        // newer revisions instead of queueing another.
+        qsizetype queuedChangesAt = -1;
+    };
+
+    void broadcastChanges();
+    void broadcast(const QJsonObject &message, bool isChanges = false);
+    void enqueue(QWebSocket *socket, const QByteArray &message, bool isChanges);
+    void flush(QWebSocket *socket);
+    void dropClient(QWebSocket *socket, const QString &reason);
+
+    ActivityManager *m_activityManager;
+    Options m_options;
+    QHash<QWebSocket *, Client> m_clients;
+    // Zero-interval single shot: every change made before control returns
+    // to the event loop is announced once.
+    QTimer *m_changesTimer;
+};
+
+#endif
@@ -0,0 +1,292 @@
+#include "eventcache.h"
+#include "database.h"
+#include "recurrencerule.h"
+#include <algorithm>
+#include <limits>
+
+QJsonObject EventRecord::toJson() const
+{
+    QJsonObject obj;
+    obj["id"] = id;
+    obj["category"] = category;
+    obj["startDate"] = startDate;
+    obj["endDate"] = endDate;
+    obj["title"] = title;
+    obj["color"] = color;
+    obj["description"] = description;
+    obj["reminderTime"] = reminderTime;
+    obj["isReminderEnabled"] = isReminderEnabled;
+    obj["recurrenceRule"] = recurrenceRule;
+    obj["recurrenceExceptions"] = recurrenceExceptions;
+    if (!seriesId.isEmpty())
+    {
+        obj["seriesId"] = seriesId;
+    }
+    return obj;
+}
+
+EventRecord EventRecord::occurrenceAt(const QDateTime &start) const
+{
+    EventRecord occurrence = *this;
+    const qint64 shift = start.toMSecsSinceEpoch() - startMs;
+    const QDateTime end = start.addMSecs(endMs - startMs);
+
+    occurrence.seriesId = id;
+    occurrence.id = QString("%1@%2").arg(id).arg(start.toMSecsSinceEpoch());
+    occurrence.startDate = start.toString(Qt::ISODate);
+    occurrence.endDate = end.toString(Qt::ISODate);
+    occurrence.startMs = start.toMSecsSinceEpoch();
+    occurrence.endMs = end.toMSecsSinceEpoch();
+
+    QDateTime reminder = Database::parseDateTime(reminderTime);
+    if (reminder.isValid())
+    {
+        occurrence.reminderTime = reminder.addMSecs(shift).toString(Qt::ISODate);
+    }
+    return occurrence;
+}
+
+EventRecord EventRecord::occurrenceForTrigger(qint64 offsetMs, qint64 triggerMs) const
+{
+    if (!isRecurring())
+    {
+        return *this;
+    }
+
+    const QDateTime seriesStart = Database::parseDateTime(startDate);
+    return occurrenceAt(QDateTime::fromMSecsSinceEpoch(triggerMs + offsetMs, seriesStart.timeZone()));
+}
+
+std::optional<qint64> EventRecord::nextTriggerMs(qint64 offsetMs, qint64 afterMs) const
+{
+    if (!timed)
+    {
+        return std::nullopt;
+    }
+    if (!isRecurring())
+    {
+        return startMs - offsetMs;
+    }
+
+    std::optional<RecurrenceRule> rule = RecurrenceRule::parse(recurrenceRule);
+    if (!rule)
+    {
+        return std::nullopt;
+    }
+
+    std::optional<QDateTime> next = rule->nextOccurrence(Database::parseDateTime(startDate), afterMs + offsetMs,
+                                                         RecurrenceRule::parseExceptions(recurrenceExceptions));
+    if (!next)
+    {
+        return std::nullopt;
+    }
+    return next->toMSecsSinceEpoch() - offsetMs;
+}
+
+std::optional<qint64> EventRecord::computeRecurrenceEndMs() const
+{
+    std::optional<RecurrenceRule> rule = RecurrenceRule::parse(recurrenceRule);
+    if (!rule || !timed)
+    {
+        return std::nullopt;
+    }
+
+    std::optional<QDateTime> last = rule->lastOccurrence(Database::parseDateTime(startDate));
+    if (!last)
+    {
+        return std::nullopt;
+    }
+    return last->toMSecsSinceEpoch() + (endMs - startMs);
+}
+
+EventRecord EventRecord::fromJson(const QString &id, const QJsonObject &data)
+{
+    EventRecord record;
+    record.id = id;
+    record.category = data["category"].toString();
+    record.startDate = data["startDate"].toString();
+    record.endDate = data["endDate"].toString();
+    record.title = data["title"].toString();
+    record.color = data["color"].toString();
+    record.description = data["description"].toString("");
+    record.reminderTime = data["reminderTime"].toString();
+    record.isReminderEnabled = data["isReminderEnabled"].toBool(false);
+    record.recurrenceRule = data["recurrenceRule"].toString();
+    record.recurrenceExceptions = data["recurrenceExceptions"].toString();
+
+    QVariant startMs = Database::toEpochMs(record.startDate);
+    QVariant endMs = Database::toEpochMs(record.endDate);
+    record.timed = !startMs.isNull() && !endMs.isNull();
+    record.startMs = startMs.toLongLong();
+    record.endMs = endMs.toLongLong();
+    if (record.isRecurring())
+    {
+        record.recurrenceEndMs = record.computeRecurrenceEndMs();
+    }
+    return record;
+}
+
+void EventCache::reset(const QList<EventRecord> &records)
+{
+    QWriteLocker locker(&m_lock);
+    m_byId.clear();
+    m_byStart.clear();
+    m_recurringIds.clear();
+    m_longIds.clear();
+    m_byId.reserve(records.size());
+    for (const EventRecord &record : records)
+    {
+        insertLocked(record);
+    }
+}
+
+void EventCache::upsert(const EventRecord &record)
+{
+    QWriteLocker locker(&m_lock);
+    removeLocked(record.id);
+    insertLocked(record);
+}
+
+void EventCache::remove(const QString &id)
+{
+    QWriteLocker locker(&m_lock);
+    removeLocked(id);
+}
+
+void EventCache::setReminderEnabled(const QString &id, bool enabled)
+{
+    QWriteLocker locker(&m_lock);
+    auto it = m_byId.find(id);
+    if (it != m_byId.end())
+    {
+        it->isReminderEnabled = enabled;
+    }
+}
+
+std::optional<EventRecord> EventCache::find(const QString &id) const
+{
+    QReadLocker locker(&m_lock);
+    auto it = m_byId.constFind(id);
+    if (it == m_byId.constEnd())
+    {
+        return std::nullopt;
+    }
+    return *it;
+}
+
+QList<EventRecord> EventCache::all() const
+{
+    QReadLocker locker(&m_lock);
+    QList<EventRecord> records;
+    records.reserve(m_byId.size());
+
+    // Untimed records first, matching ORDER BY start_ms (NULLs first).
+    for (const EventRecord &record : m_byId)
+    {
+        if (!record.timed)
+        {
+            records.append(record);
+        }
+    }
+    for (const auto &[startMs, id] : m_byStart)
+    {
+        records.append(m_byId.value(id));
+    }
+    return records;
+}
+
+QList<EventRecord> EventCache::overlapping(qint64 fromMs, qint64 toMs) const
+{
+    QReadLocker locker(&m_lock);
+    QList<EventRecord> records;
+
+    qint64 scanFrom = fromMs > std::numeric_limits<qint64>::min() + longEventMs ? fromMs - longEventMs : std::numeric_limits<qint64>::min();
+    for (auto it = m_byStart.lower_bound({scanFrom, QString()}); it != m_byStart.end() && it->first <= toMs; ++it)
+    {
+        const EventRecord &record = *m_byId.constFind(it->second);
+        if (record.endMs >= fromMs && !record.isRecurring() && !isLong(record))
+        {
+            records.append(record);
+        }
+    }
+
+    if (m_longIds.isEmpty())
+    {
+        return records;
+    }
+    for (const QString &id : m_longIds)
+    {
+        const EventRecord &record = *m_byId.constFind(id);
+        if (record.startMs <= toMs && record.endMs >= fromMs)
+        {
+            records.append(record);
+        }
+    }
+    std::stable_sort(records.begin(), records.end(), [](const EventRecord &a, const EventRecord &b)
+                     { return a.startMs < b.startMs; });
+    return records;
+}
+
+QList<EventRecord> EventCache::recurring(qint64 fromMs, qint64 toMs) const
+{
+    QReadLocker locker(&m_lock);
+    QList<EventRecord> records;
+    for (const QString &id : m_recurringIds)
+    {
+        const EventRecord &record = *m_byId.constFind(id);
+        if (record.timed && record.startMs <= toMs && (!record.recurrenceEndMs || *record.recurrenceEndMs >= fromMs))
+        {
+            records.append(record);
+        }
+    }
+    return records;
+}
+
+QList<EventRecord> EventCache::startingFrom(qint64 fromMs, int limit) const
+{
+    QReadLocker locker(&m_lock);
+    QList<EventRecord> records;
+    for (auto it = m_byStart.lower_bound({fromMs, QString()}); it != m_byStart.end() && records.size() < limit; ++it)
+    {
+        records.append(m_byId.value(it->second));
+    }
+    return records;
+}
+
+void EventCache::insertLocked(const EventRecord &record)
+{
+    m_byId.insert(record.id, record);
+    if (record.isRecurring())
+    {
+        m_recurringIds.insert(record.id);
+    }
+    if (record.timed)
+    {
+        m_byStart.insert({record.startMs, record.id});
+        if (isLong(record))
+        {
+            m_longIds.insert(record.id);
+        }
+    }
+}
+
+void EventCache::removeLocked(const QString &id)
+{
+    auto it = m_byId.find(id);
+    if (it == m_byId.end())
+    {
+        return;
+    }
+    if (it->timed)
+    {
+        m_byStart.erase({it->startMs, id});
+    }
+    m_recurringIds.remove(id);
+    m_longIds.remove(id);
+    m_byId.erase(it);
+}
+
+bool EventCache::isLong(const EventRecord &record)
+{
+    return record.timed && !record.isRecurring() && record.endMs - record.startMs > longEventMs;
+}
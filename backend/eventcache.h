@@ -0,0 +1,94 @@
+#ifndef EVENTCACHE_H
+#define EVENTCACHE_H
+
+#include <QString>
+#include <QHash>
+#include <QList>
+#include <QJsonObject>
+#include <QReadWriteLock>
+#include <QSet>
+#include <QDateTime>
+#include <optional>
+#include <set>
+#include <utility>
+
+// One events row as held in memory by EventCache.
+struct EventRecord
+{
+    QString id;
+    QString category;
+    QString startDate;
+    QString endDate;
+    QString title;
+    QString color;
+    QString description;
+    QString reminderTime;
+    bool isReminderEnabled = false;
+    // RRULE text and EXDATE-style exception list; empty for one-off events.
+    QString recurrenceRule;
+    QString recurrenceExceptions;
+    // Set on occurrences expanded from a series: the series id.
+    QString seriesId;
+
+    // UTC epoch ms parsed from startDate/endDate; only meaningful when timed.
+    qint64 startMs = 0;
+    qint64 endMs = 0;
+    bool timed = false;
+    // End of the last occurrence of a bounded series.
+    std::optional<qint64> recurrenceEndMs;
+
+    bool isRecurring() const { return !recurrenceRule.isEmpty(); }
+    // Copy of this series shifted to the occurrence starting at start.
+    EventRecord occurrenceAt(const QDateTime &start) const;
+    // Copy of the occurrence whose reminder, offsetMs before its start,
+    // triggers at triggerMs.
+    EventRecord occurrenceForTrigger(qint64 offsetMs, qint64 triggerMs) const;
+    // Earliest trigger after afterMs of a reminder offsetMs before each
+    // occurrence; for one-off events simply start - offset. nullopt when the
+    // series has ended.
+    std::optional<qint64> nextTriggerMs(qint64 offsetMs, qint64 afterMs) const;
+    // End of the series' last occurrence, nullopt when unbounded.
+    std::optional<qint64> computeRecurrenceEndMs() const;
+
+    QJsonObject toJson() const;
+    static EventRecord fromJson(const QString &id, const QJsonObject &data);
+};
+
+// Thread-safe in-memory copy of the events table: a hash by id plus an
+// index ordered by start time. Range lookups scan the start index from
+// (from - longEventMs), which finds every event up to that long; the few
+// longer ones are kept in a separate list that is checked in full, so a
+// single year-long event does not widen every scan. Recurring series are
+// kept apart and returned by recurring() for expansion.
+class EventCache
+{
+public:
+    void reset(const QList<EventRecord> &records);
+    void upsert(const EventRecord &record);
+    void remove(const QString &id);
+    void setReminderEnabled(const QString &id, bool enabled);
+
+    std::optional<EventRecord> find(const QString &id) const;
+    QList<EventRecord> all() const;
+    // One-off events overlapping [fromMs, toMs].
+    QList<EventRecord> overlapping(qint64 fromMs, qint64 toMs) const;
+    // Series that may have occurrences in [fromMs, toMs].
+    QList<EventRecord> recurring(qint64 fromMs, qint64 toMs) const;
+    QList<EventRecord> startingFrom(qint64 fromMs, int limit) const;
+
+private:
+    void insertLocked(const EventRecord &record);
+    void removeLocked(const QString &id);
+    static bool isLong(const EventRecord &record);
+
+    static constexpr qint64 longEventMs = 7LL * 24 * 60 * 60 * 1000;
+
+    mutable QReadWriteLock m_lock;
+    QHash<QString, EventRecord> m_byId;
+    std::set<std::pair<qint64, QString>> m_byStart;
+    QSet<QString> m_recurringIds;
+    // Timed one-off events lasting longer than longEventMs.
+    QSet<QString> m_longIds;
+};
+
+#endif
\ No newline at end of file
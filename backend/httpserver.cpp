@@ -1,26 +1,159 @@
 #include "httpserver.h"
 #include "activitymanager.h"
 #include "alarmmanager.h"
+#include "database.h"
+#include "staticassetcache.h"
+#include "eventbroadcaster.h"
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QHostAddress>
 #include <QDebug>
 #include <QFile>
-#include <QFileInfo>
 #include <QDir>
 #include <QCoreApplication>
-#include <QMimeDatabase>
+#include <QHttpHeaders>
+#include <QHttpServerWebSocketUpgradeResponse>
+#include <QWebSocket>
+#include <QDateTime>
+#include <QHash>
+#include <QUrlQuery>
+#include <QSemaphore>
+#include <QThreadPool>
+#include <QPromise>
+#include <QtConcurrent>
+
+namespace
+{
+    // True when the Accept-Encoding header lists coding without q=0.
+    bool acceptsEncoding(QByteArrayView header, const QByteArray &coding)
+    {
+        for (const QByteArray &entry : header.toByteArray().toLower().split(','))
+        {
+            const QList<QByteArray> parts = entry.split(';');
+            if (parts.first().trimmed() != coding)
+            {
+                continue;
+            }
+            for (const QByteArray &param : parts.mid(1))
+            {
+                if (param.trimmed().startsWith("q="))
+                {
+                    return param.trimmed().mid(2).toDouble() > 0;
+                }
+            }
+            return true;
+        }
+        return false;
+    }
+
+    // True when If-None-Match lists etag (or "*").
+    bool matchesIfNoneMatch(const QHttpServerRequest &request, const QByteArray &etag)
+    {
+        const QByteArrayView ifNoneMatch = request.headers().value(QHttpHeaders::WellKnownHeader::IfNoneMatch);
+        for (const QByteArray &candidate : ifNoneMatch.toByteArray().split(','))
+        {
+            if (candidate.trimmed() == "*" || candidate.trimmed() == etag)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Picks the smallest representation the client accepts. Each one gets
+    // its own strong ETag, as strong validators must not be shared between
+    // encodings.
+    QHttpServerResponse staticAssetResponse(const StaticAsset &asset, const QHttpServerRequest &request)
+    {
+        const QByteArrayView acceptEncoding = request.headers().value(QHttpHeaders::WellKnownHeader::AcceptEncoding);
+        QByteArray body = asset.body;
+        QByteArray encoding;
+        if (!asset.brotli.isEmpty() && acceptsEncoding(acceptEncoding, "br"))
+        {
+            body = asset.brotli;
+            encoding = "br";
+        }
+        else if (!asset.gzip.isEmpty() && acceptsEncoding(acceptEncoding, "gzip"))
+        {
+            body = asset.gzip;
+            encoding = "gzip";
+        }
+        else if (!asset.deflate.isEmpty() && acceptsEncoding(acceptEncoding, "deflate"))
+        {
+            body = asset.deflate;
+            encoding = "deflate";
+        }
+
+        const QByteArray etag = encoding.isEmpty() ? asset.etag : asset.etag.chopped(1) + '-' + encoding + '"';
+        auto withCachingHeaders = [&](QHttpServerResponse response)
+        {
+            QHttpHeaders headers = response.headers();
+            headers.append(QHttpHeaders::WellKnownHeader::ETag, etag);
+            // Hashed chunks can be cached for good; everything else (HTML
+            // especially) is revalidated against the ETag on each load.
+            headers.append(QHttpHeaders::WellKnownHeader::CacheControl,
+                           asset.immutable ? "public, max-age=31536000, immutable" : "no-cache");
+            if (!asset.brotli.isEmpty() || !asset.gzip.isEmpty() || !asset.deflate.isEmpty())
+            {
+                headers.append(QHttpHeaders::WellKnownHeader::Vary, "Accept-Encoding");
+            }
+            response.setHeaders(std::move(headers));
+            return response;
+        };
+
+        if (matchesIfNoneMatch(request, etag))
+        {
+            return withCachingHeaders(QHttpServerResponse(QHttpServerResponse::StatusCode::NotModified));
+        }
+
+        QHttpServerResponse response = withCachingHeaders(QHttpServerResponse(asset.mimeType, body));
+        if (!encoding.isEmpty())
+        {
+            QHttpHeaders headers = response.headers();
+            headers.append(QHttpHeaders::WellKnownHeader::ContentEncoding, encoding);
+            response.setHeaders(std::move(headers));
+        }
+        return response;
+    }
+
+    // Accepts epoch milliseconds or an ISO 8601 date-time.
+    QVariant parseTimeParam(const QString &value)
+    {
+        bool isNumber = false;
+        qlonglong ms = value.toLongLong(&isNumber);
+        return isNumber ? QVariant(ms) : Database::toEpochMs(value);
+    }
+}
 
 HttpServer::HttpServer(ActivityManager *activityMgr, AlarmManager *alarmMgr, QObject *parent)
-    : QObject(parent), m_activityManager(activityMgr), m_alarmManager(alarmMgr), m_port(0)
+    : QObject(parent), m_activityManager(activityMgr), m_alarmManager(alarmMgr), m_port(0), m_assets(nullptr), m_broadcaster(nullptr), m_revisionEpoch(QDateTime::currentMSecsSinceEpoch())
 {
     m_server = new QHttpServer(this);
+    m_workerPool = new QThreadPool(this);
+    // Workers never retire: each owns a SQLite connection and its prepared
+    // statement cache, which an idle-thread expiry would throw away and
+    // rebuild on the next burst. workerThreads bounds what is kept.
+    m_workerPool->setExpiryTimeout(-1);
+    m_broadcaster = new EventBroadcaster(activityMgr, alarmMgr, this);
+    setOptions(Options());
     m_frontendPath = findFrontendPath();
     setupRoutes();
+    setupEventStream();
     setupStaticRoutes();
 }
 
+void HttpServer::setOptions(const Options &options)
+{
+    m_workerPool->setMaxThreadCount(qMax(1, options.workerThreads));
+    m_maxPendingRequests = qMax(1, options.maxPendingRequests);
+
+    EventBroadcaster::Options streamOptions;
+    streamOptions.maxClients = options.maxStreamClients;
+    m_broadcaster->setOptions(streamOptions);
+    m_devOrigin = options.devOrigin.toUtf8();
+}
+
 bool HttpServer::start(quint16 port)
 {
     m_tcpServer = std::make_unique<QTcpServer>();
@@ -51,12 +184,21 @@ bool HttpServer::start(quint16 port)
     return true;
 }
 
+HttpServer::~HttpServer()
+{
+    stop();
+}
+
 void HttpServer::stop()
 {
-    if (m_server)
+    if (!m_stopping.testAndSetRelaxed(0, 1))
     {
-        qInfo() << "🛑 Stopping HTTP server...";
+        return;
     }
+    qInfo() << "🛑 Stopping HTTP server...";
+    // Workers use this object and the managers, so the queued and running
+    // ones must finish before any of that is destroyed.
+    m_workerPool->waitForDone();
 }
 
 quint16 HttpServer::getPort() const
@@ -102,14 +244,77 @@ void HttpServer::setupRoutes()
                         return addCorsHeaders(QHttpServerResponse(QHttpServerResponse::StatusCode::Ok));
                     });
 
+    m_server->route("/api/event/<arg>/reminders", QHttpServerRequest::Method::Options,
+                    [addCorsHeaders](const QString &)
+                    {
+                        qDebug() << "📋 OPTIONS /api/event/:id/reminders";
+                        return addCorsHeaders(QHttpServerResponse(QHttpServerResponse::StatusCode::Ok));
+                    });
+
+    m_server->route("/api/event/<arg>/reminders/<arg>", QHttpServerRequest::Method::Options,
+                    [addCorsHeaders](const QString &, const QString &)
+                    {
+                        qDebug() << "📋 OPTIONS /api/event/:id/reminders/:reminderId";
+                        return addCorsHeaders(QHttpServerResponse(QHttpServerResponse::StatusCode::Ok));
+                    });
+
     // ============ EVENT ROUTES (Calendar API) ============
+    // Handlers only parse the request on the event loop; database work runs
+    // on the worker pool so a slow query never stalls the UI or other requests.
 
+    // GET /api/event - All events, only those overlapping ?from=&to=, or a
+    // keyset page when limit/cursor/fields is given.
     m_server->route("/api/event", QHttpServerRequest::Method::Get,
-                    [this, addCorsHeaders]()
+                    [this, addCorsHeaders](const QHttpServerRequest &request, QHttpServerResponder &responder)
                     {
-                        qDebug() << "🔍 GET /api/event";
-                        QJsonArray events = m_activityManager->getAllActivities();
-                        return addCorsHeaders(jsonResponse(events));
+                        qDebug() << "🔍 GET /api/event" << request.query().toString();
+                        QUrlQuery params = request.query();
+
+                        // Answered from the revision counter alone when the
+                        // client's copy is current.
+                        const qint64 revision = m_activityManager->dataRevision();
+                        if (matchesIfNoneMatch(request, revisionETag(revision)))
+                        {
+                            responder.sendResponse(addCorsHeaders(withRevision(QHttpServerResponse(QHttpServerResponse::StatusCode::NotModified), revision)));
+                            return;
+                        }
+
+                        if (params.hasQueryItem("from") || params.hasQueryItem("to"))
+                        {
+                            QVariant from = parseTimeParam(params.queryItemValue("from"));
+                            QVariant to = parseTimeParam(params.queryItemValue("to"));
+                            if (from.isNull() || to.isNull())
+                            {
+                                responder.sendResponse(addCorsHeaders(errorResponse("from and to must both be ISO 8601 date-times or epoch milliseconds")));
+                                return;
+                            }
+
+                            respond(responder, runAsync([this, addCorsHeaders, from, to, revision]()
+                                                        {
+                                QJsonArray events = m_activityManager->getActivitiesInRange(from.toLongLong(), to.toLongLong());
+                                return addCorsHeaders(withRevision(jsonResponse(events), revision)); }));
+                            return;
+                        }
+
+                        if (params.hasQueryItem("limit") || params.hasQueryItem("cursor") || params.hasQueryItem("fields"))
+                        {
+                            int limit = params.queryItemValue("limit").toInt();
+                            QString cursor = params.queryItemValue("cursor");
+                            QStringList fields = params.queryItemValue("fields").split(',', Qt::SkipEmptyParts);
+
+                            respond(responder, runAsync([this, addCorsHeaders, limit, cursor, fields, revision]()
+                                                        {
+                                QJsonObject page = m_activityManager->getActivitiesPage(limit, cursor, fields);
+                                if (page.contains("error"))
+                                {
+                                    return addCorsHeaders(errorResponse(page["error"].toString()));
+                                }
+                                return addCorsHeaders(withRevision(jsonResponse(page), revision)); }));
+                            return;
+                        }
+
+                        // The full listing can be large: stream it as chunked compact JSON.
+                        streamAllActivities(responder, revision);
                     });
 
     m_server->route("/api/event", QHttpServerRequest::Method::Post,
@@ -120,32 +325,139 @@ void HttpServer::setupRoutes()
                         QJsonObject data = parseRequestBody(request);
                         qDebug() << "🔧 Parsed JSON:" << data;
 
-                        QJsonObject event = m_activityManager->createActivity(data);
-                        if (event.contains("error"))
+                        return runAsync([this, addCorsHeaders, data]()
+                                        {
+                            QJsonObject event = m_activityManager->createActivity(data);
+                            if (event.contains("error"))
+                            {
+                                return addCorsHeaders(errorResponse(event["error"].toString()));
+                            }
+
+                            return addCorsHeaders(jsonResponse(event, QHttpServerResponse::StatusCode::Created)); });
+                    });
+
+    // POST /api/event/batch - Import many events in one transaction.
+    // Accepts a JSON array or NDJSON (one event object per line).
+    m_server->route("/api/event/batch", QHttpServerRequest::Method::Post,
+                    [this, addCorsHeaders](const QHttpServerRequest &request)
+                    {
+                        QByteArray body = request.body();
+                        qDebug() << "📦 POST /api/event/batch (" << body.size() << "bytes)";
+
+                        return runAsync([this, addCorsHeaders, body]()
+                                        {
+                            QJsonArray items;
+                            QHash<int, QString> parseErrors;
+                            if (body.trimmed().startsWith('['))
+                            {
+                                QJsonParseError error;
+                                QJsonDocument doc = QJsonDocument::fromJson(body, &error);
+                                if (error.error != QJsonParseError::NoError)
+                                {
+                                    return addCorsHeaders(errorResponse("Invalid JSON array: " + error.errorString()));
+                                }
+                                items = doc.array();
+                            }
+                            else
+                            {
+                                const QList<QByteArray> lines = body.split('\n');
+                                for (const QByteArray &line : lines)
+                                {
+                                    if (line.trimmed().isEmpty())
+                                    {
+                                        continue;
+                                    }
+                                    QJsonParseError error;
+                                    QJsonDocument doc = QJsonDocument::fromJson(line, &error);
+                                    if (error.error != QJsonParseError::NoError)
+                                    {
+                                        parseErrors.insert(items.size(), "Invalid JSON: " + error.errorString());
+                                    }
+                                    items.append(doc.object());
+                                }
+                            }
+
+                            QJsonObject result = m_activityManager->createActivities(items);
+                            if (result.contains("error"))
+                            {
+                                return addCorsHeaders(errorResponse(result["error"].toString(), QHttpServerResponse::StatusCode::InternalServerError));
+                            }
+
+                            // Lines that failed to parse were imported as empty objects and
+                            // rejected by validation; report the parse error instead.
+                            QJsonArray errors = result["errors"].toArray();
+                            if (!parseErrors.isEmpty())
+                            {
+                                for (int i = 0; i < errors.size(); ++i)
+                                {
+                                    QJsonObject error = errors[i].toObject();
+                                    int index = error["index"].toInt();
+                                    if (parseErrors.contains(index))
+                                    {
+                                        error["error"] = parseErrors.value(index);
+                                        errors[i] = error;
+                                    }
+                                }
+                                result["errors"] = errors;
+                            }
+
+                            QJsonArray ids = result["ids"].toArray();
+                            QHttpServerResponse::StatusCode code = ids.isEmpty() && !errors.isEmpty()
+                                                                       ? QHttpServerResponse::StatusCode::BadRequest
+                                                                       : QHttpServerResponse::StatusCode::Created;
+                            return addCorsHeaders(jsonResponse(result, code)); });
+                    });
+
+    // GET /api/event/changes?since=REV - Events created, updated or deleted
+    // after a revision. Registered before /api/event/<arg> so "changes" is
+    // not taken for an id.
+    m_server->route("/api/event/changes", QHttpServerRequest::Method::Get,
+                    [this, addCorsHeaders](const QHttpServerRequest &request)
+                    {
+                        qDebug() << "🔄 GET /api/event/changes" << request.query().toString();
+                        QUrlQuery params = request.query();
+
+                        bool ok = true;
+                        qint64 since = 0;
+                        if (params.hasQueryItem("since"))
                         {
-                            return addCorsHeaders(errorResponse(event["error"].toString()));
+                            since = params.queryItemValue("since").toLongLong(&ok);
                         }
-
-                        if (data.value("isReminderEnabled").toBool(false))
+                        if (!ok || since < 0)
                         {
-                            m_alarmManager->reloadAlarms();
-                            qInfo() << "⏰ Reloaded alarms after creating event with reminder";
+                            return readyFuture(addCorsHeaders(errorResponse("since must be a non-negative revision number")));
                         }
 
-                        return addCorsHeaders(jsonResponse(event, QHttpServerResponse::StatusCode::Created));
+                        int limit = params.queryItemValue("limit").toInt();
+                        return runAsync([this, addCorsHeaders, since, limit]()
+                                        {
+                            QJsonObject changes = m_activityManager->getChanges(since, limit);
+                            if (changes.contains("error"))
+                            {
+                                return addCorsHeaders(errorResponse(changes));
+                            }
+                            return addCorsHeaders(jsonResponse(changes)); });
                     });
 
     // GET /api/event/:id - Get single event
     m_server->route("/api/event/<arg>", QHttpServerRequest::Method::Get,
-                    [this, addCorsHeaders](const QString &id)
+                    [this, addCorsHeaders](const QString &id, const QHttpServerRequest &request)
                     {
                         qDebug() << "🔍 GET /api/event/" << id;
-                        QJsonObject event = m_activityManager->getActivityById(id);
-                        if (event.contains("error"))
+                        const qint64 revision = m_activityManager->dataRevision();
+                        if (matchesIfNoneMatch(request, revisionETag(revision)))
                         {
-                            return addCorsHeaders(errorResponse(event["error"].toString(), QHttpServerResponse::StatusCode::NotFound));
+                            return readyFuture(addCorsHeaders(withRevision(QHttpServerResponse(QHttpServerResponse::StatusCode::NotModified), revision)));
                         }
-                        return addCorsHeaders(jsonResponse(event));
+
+                        return runAsync([this, addCorsHeaders, id, revision]()
+                                        {
+                            QJsonObject event = m_activityManager->getActivityById(id);
+                            if (event.contains("error"))
+                            {
+                                return addCorsHeaders(errorResponse(event));
+                            }
+                            return addCorsHeaders(withRevision(jsonResponse(event), revision)); });
                     });
 
     // PUT /api/event/:id - Update event
@@ -155,19 +467,33 @@ void HttpServer::setupRoutes()
                         qDebug() << "✏️ PUT /api/event/" << id;
                         QJsonObject data = parseRequestBody(request);
 
-                        QJsonObject event = m_activityManager->updateActivity(id, data);
-                        if (event.contains("error"))
-                        {
-                            return addCorsHeaders(errorResponse(event["error"].toString()));
-                        }
+                        return runAsync([this, addCorsHeaders, id, data]()
+                                        {
+                            QJsonObject event = m_activityManager->updateActivity(id, data);
+                            if (event.contains("error"))
+                            {
+                                return addCorsHeaders(errorResponse(event));
+                            }
 
-                        if (data.contains("isReminderEnabled") || data.contains("reminderTime"))
-                        {
-                            m_alarmManager->reloadAlarms();
-                            qInfo() << "⏰ Reloaded alarms after updating event reminder";
-                        }
+                            return addCorsHeaders(jsonResponse(event)); });
+                    });
 
-                        return addCorsHeaders(jsonResponse(event));
+    // PATCH /api/event/:id - Update only the fields present in the body
+    m_server->route("/api/event/<arg>", QHttpServerRequest::Method::Patch,
+                    [this, addCorsHeaders](const QString &id, const QHttpServerRequest &request)
+                    {
+                        qDebug() << "🩹 PATCH /api/event/" << id;
+                        QJsonObject data = parseRequestBody(request);
+
+                        return runAsync([this, addCorsHeaders, id, data]()
+                                        {
+                            QJsonObject event = m_activityManager->patchActivity(id, data);
+                            if (event.contains("error"))
+                            {
+                                return addCorsHeaders(errorResponse(event));
+                            }
+
+                            return addCorsHeaders(jsonResponse(event)); });
                     });
 
     // DELETE /api/event/:id - Delete event
@@ -175,25 +501,99 @@ void HttpServer::setupRoutes()
                     [this, addCorsHeaders](const QString &id)
                     {
                         qDebug() << "🗑️ DELETE /api/event/" << id;
-                        bool success = m_activityManager->deleteActivity(id);
-                        if (!success)
-                        {
-                            return addCorsHeaders(errorResponse("Failed to delete event"));
-                        }
+                        return runAsync([this, addCorsHeaders, id]()
+                                        {
+                            QJsonObject result = m_activityManager->deleteActivity(id);
+                            if (result.contains("error"))
+                            {
+                                return addCorsHeaders(errorResponse(result));
+                            }
+
+                            return addCorsHeaders(jsonResponse(result)); });
+                    });
 
-                        m_alarmManager->reloadAlarms();
-                        qInfo() << "⏰ Reloaded alarms after deleting event";
+    // ============ REMINDER ROUTES ============
+    // An event can have several reminders, each offsetMs before its start.
 
-                        return addCorsHeaders(jsonResponse(QJsonObject{{"message", "Event deleted successfully"}}));
+    // GET /api/event/:id/reminders - List an event's reminders
+    m_server->route("/api/event/<arg>/reminders", QHttpServerRequest::Method::Get,
+                    [this, addCorsHeaders](const QString &id)
+                    {
+                        qDebug() << "🔍 GET /api/event/" << id << "/reminders";
+                        return runAsync([this, addCorsHeaders, id]()
+                                        {
+                            QJsonObject result = m_activityManager->getReminders(id);
+                            if (result.contains("error"))
+                            {
+                                return addCorsHeaders(errorResponse(result));
+                            }
+
+                            return addCorsHeaders(jsonResponse(result["reminders"].toArray())); });
+                    });
+
+    // POST /api/event/:id/reminders - Add a reminder {"offsetMs": ...}
+    m_server->route("/api/event/<arg>/reminders", QHttpServerRequest::Method::Post,
+                    [this, addCorsHeaders](const QString &id, const QHttpServerRequest &request)
+                    {
+                        qDebug() << "📝 POST /api/event/" << id << "/reminders";
+                        QJsonObject data = parseRequestBody(request);
+
+                        return runAsync([this, addCorsHeaders, id, data]()
+                                        {
+                            QJsonObject reminder = m_activityManager->createReminder(id, data);
+                            if (reminder.contains("error"))
+                            {
+                                return addCorsHeaders(errorResponse(reminder));
+                            }
+
+                            return addCorsHeaders(jsonResponse(reminder, QHttpServerResponse::StatusCode::Created)); });
+                    });
+
+    // PUT /api/event/:id/reminders/:reminderId - Change a reminder's offset
+    m_server->route("/api/event/<arg>/reminders/<arg>", QHttpServerRequest::Method::Put,
+                    [this, addCorsHeaders](const QString &id, const QString &reminderId, const QHttpServerRequest &request)
+                    {
+                        qDebug() << "✏️ PUT /api/event/" << id << "/reminders/" << reminderId;
+                        QJsonObject data = parseRequestBody(request);
+
+                        return runAsync([this, addCorsHeaders, id, reminderId, data]()
+                                        {
+                            QJsonObject reminder = m_activityManager->updateReminder(id, reminderId, data);
+                            if (reminder.contains("error"))
+                            {
+                                return addCorsHeaders(errorResponse(reminder));
+                            }
+
+                            return addCorsHeaders(jsonResponse(reminder)); });
+                    });
+
+    // DELETE /api/event/:id/reminders/:reminderId - Remove a reminder
+    m_server->route("/api/event/<arg>/reminders/<arg>", QHttpServerRequest::Method::Delete,
+                    [this, addCorsHeaders](const QString &id, const QString &reminderId)
+                    {
+                        qDebug() << "🗑️ DELETE /api/event/" << id << "/reminders/" << reminderId;
+                        return runAsync([this, addCorsHeaders, id, reminderId]()
+                                        {
+                            QJsonObject result = m_activityManager->deleteReminder(id, reminderId);
+                            if (result.contains("error"))
+                            {
+                                return addCorsHeaders(errorResponse(result));
+                            }
+
+                            return addCorsHeaders(jsonResponse(result)); });
                     });
 
     m_server->route("/status", QHttpServerRequest::Method::Get,
-                    [addCorsHeaders]()
+                    [this, addCorsHeaders]()
                     {
                         qDebug() << "🔍 GET /status";
                         QJsonObject response;
                         response["status"] = "Daily Reminder Backend is running!";
                         response["service"] = "Qt Daily Reminder HTTP API";
+                        response["statementCache"] = QJsonObject{
+                            {"hits", qint64(Database::instance().statementCacheHits())},
+                            {"misses", qint64(Database::instance().statementCacheMisses())}};
+                        response["alarmLatency"] = m_alarmManager->latencyStats();
                         return addCorsHeaders(QHttpServerResponse(response));
                     });
 
@@ -203,13 +603,147 @@ void HttpServer::setupRoutes()
 QHttpServerResponse HttpServer::jsonResponse(const QJsonObject &obj, QHttpServerResponse::StatusCode code)
 {
     QJsonDocument doc(obj);
-    return QHttpServerResponse("application/json", doc.toJson(), code);
+    return QHttpServerResponse("application/json", doc.toJson(QJsonDocument::Compact), code);
 }
 
 QHttpServerResponse HttpServer::jsonResponse(const QJsonArray &arr, QHttpServerResponse::StatusCode code)
 {
     QJsonDocument doc(arr);
-    return QHttpServerResponse("application/json", doc.toJson(), code);
+    return QHttpServerResponse("application/json", doc.toJson(QJsonDocument::Compact), code);
+}
+
+QByteArray HttpServer::revisionETag(qint64 revision) const
+{
+    return QByteArray("\"") + QByteArray::number(m_revisionEpoch, 36) + '-' + QByteArray::number(revision) + '"';
+}
+
+QHttpHeaders HttpServer::revisionHeaders(qint64 revision) const
+{
+    QHttpHeaders headers;
+    headers.append(QHttpHeaders::WellKnownHeader::ETag, revisionETag(revision));
+    headers.append("X-Data-Revision", QByteArray::number(revision));
+    // Cacheable, but always revalidated: the ETag makes that a 304.
+    headers.append(QHttpHeaders::WellKnownHeader::CacheControl, "no-cache");
+    return headers;
+}
+
+QHttpServerResponse HttpServer::withRevision(QHttpServerResponse response, qint64 revision) const
+{
+    QHttpHeaders headers = response.headers();
+    const QHttpHeaders extra = revisionHeaders(revision);
+    for (qsizetype i = 0; i < extra.size(); ++i)
+    {
+        headers.append(extra.nameAt(i), extra.valueAt(i));
+    }
+    response.setHeaders(std::move(headers));
+    return response;
+}
+
+QFuture<QHttpServerResponse> HttpServer::readyFuture(QHttpServerResponse &&response)
+{
+    QPromise<QHttpServerResponse> promise;
+    promise.start();
+    promise.addResult(std::move(response));
+    promise.finish();
+    return promise.future();
+}
+
+bool HttpServer::reserveRequestSlot()
+{
+    if (m_pendingRequests.fetchAndAddRelaxed(1) >= m_maxPendingRequests)
+    {
+        m_pendingRequests.fetchAndAddRelaxed(-1);
+        qWarning() << "⚠️ Request queue full (" << m_maxPendingRequests << "pending) - rejecting request";
+        return false;
+    }
+    return true;
+}
+
+QFuture<QHttpServerResponse> HttpServer::runAsync(std::function<QHttpServerResponse()> work)
+{
+    if (!reserveRequestSlot())
+    {
+        return readyFuture(errorResponse("Server is busy, please retry", QHttpServerResponse::StatusCode::ServiceUnavailable));
+    }
+
+    return QtConcurrent::run(m_workerPool, [this, work = std::move(work)]()
+                             {
+        QHttpServerResponse response = work();
+        m_pendingRequests.fetchAndAddRelaxed(-1);
+        return response; });
+}
+
+void HttpServer::respond(QHttpServerResponder &responder, QFuture<QHttpServerResponse> future)
+{
+    auto shared = std::make_shared<QHttpServerResponder>(std::move(responder));
+    future.then(this, [shared](QFuture<QHttpServerResponse> result)
+                { shared->sendResponse(result.takeResult()); });
+}
+
+void HttpServer::streamAllActivities(QHttpServerResponder &responder, qint64 revision)
+{
+    if (!reserveRequestSlot())
+    {
+        responder.sendResponse(errorResponse("Server is busy, please retry", QHttpServerResponse::StatusCode::ServiceUnavailable));
+        return;
+    }
+
+    // The worker serializes chunks and queues them to this thread, which owns
+    // the socket. The semaphore only keeps the worker from running ahead of
+    // the event loop; the responder gives no view of the socket, so a slow
+    // client still has the unsent rest of the table buffered in QTcpSocket.
+    constexpr int maxChunksInFlight = 4;
+    auto shared = std::make_shared<QHttpServerResponder>(std::move(responder));
+    auto window = std::make_shared<QSemaphore>(maxChunksInFlight);
+
+    QHttpHeaders headers = revisionHeaders(revision);
+    headers.append(QHttpHeaders::WellKnownHeader::ContentType, "application/json");
+
+    m_workerPool->start([this, shared, window, headers]()
+                        {
+        bool started = false;
+        bool ok = m_activityManager->streamAllActivities([&](const QByteArray &chunk)
+                                                         {
+            // Give up if the event loop stops draining, or at once when
+            // stop() is waiting for this worker with the loop blocked.
+            int waitedMs = 0;
+            while (!window->tryAcquire(1, 100))
+            {
+                waitedMs += 100;
+                if (m_stopping.loadRelaxed() || waitedMs >= 30000)
+                {
+                    return false;
+                }
+            }
+
+            bool first = !started;
+            started = true;
+            QMetaObject::invokeMethod(this, [shared, window, chunk, first, headers]()
+                                      {
+                if (first)
+                {
+                    shared->writeBeginChunked(headers);
+                }
+                shared->writeChunk(chunk);
+                window->release(); }, Qt::QueuedConnection);
+            return true; });
+
+        QMetaObject::invokeMethod(this, [this, shared, started, ok]()
+                                  {
+            if (started)
+            {
+                shared->writeEndChunked(QByteArray());
+            }
+            else
+            {
+                shared->sendResponse(errorResponse("Failed to fetch events", QHttpServerResponse::StatusCode::InternalServerError));
+            }
+            if (!ok)
+            {
+                qWarning() << "⚠️ Event stream ended early";
+            } }, Qt::QueuedConnection);
+
+        m_pendingRequests.fetchAndAddRelaxed(-1); });
 }
 
 QHttpServerResponse HttpServer::errorResponse(const QString &message, QHttpServerResponse::StatusCode code)
@@ -219,8 +753,25 @@ QHttpServerResponse HttpServer::errorResponse(const QString &message, QHttpServe
     return jsonResponse(obj, code);
 }
 
+QHttpServerResponse HttpServer::errorResponse(const QJsonObject &result)
+{
+    auto code = static_cast<QHttpServerResponse::StatusCode>(
+        result.value("status").toInt(int(QHttpServerResponse::StatusCode::BadRequest)));
+    return errorResponse(result["error"].toString(), code);
+}
+
 QString HttpServer::findFrontendPath()
 {
+#ifdef EMBED_FRONTEND
+    // Built with -DEMBED_FRONTEND=ON: the bundle is compiled in, so the
+    // filesystem is never probed.
+    if (QFile::exists(":/frontend/index.html"))
+    {
+        qInfo() << "✅ Using embedded frontend";
+        return ":/frontend";
+    }
+#endif
+
     // Try to find frontend build directory
     QStringList frontendPaths = {
         QCoreApplication::applicationDirPath() + "/frontend",                // Relative to binary
@@ -248,31 +799,44 @@ QString HttpServer::findFrontendPath()
     return QString();
 }
 
-QString HttpServer::getMimeType(const QString &filePath)
+void HttpServer::setupEventStream()
 {
-    QMimeDatabase mimeDb;
-    QMimeType mimeType = mimeDb.mimeTypeForFile(filePath);
-    QString mime = mimeType.name();
-
-    // Override for specific extensions that might not be detected correctly
-    if (filePath.endsWith(".js"))
-        return "application/javascript";
-    if (filePath.endsWith(".mjs"))
-        return "application/javascript";
-    if (filePath.endsWith(".css"))
-        return "text/css";
-    if (filePath.endsWith(".html"))
-        return "text/html";
-    if (filePath.endsWith(".json"))
-        return "application/json";
-    if (filePath.endsWith(".svg"))
-        return "image/svg+xml";
-    if (filePath.endsWith(".woff2"))
-        return "font/woff2";
-    if (filePath.endsWith(".woff"))
-        return "font/woff";
-
-    return mime;
+    // /api/stream - WebSocket that pushes event changes and alarms
+    m_server->addWebSocketUpgradeVerifier(this, [this](const QHttpServerRequest &request)
+                                          {
+        if (request.url().path() != "/api/stream")
+        {
+            return QHttpServerWebSocketUpgradeResponse::passToNext();
+        }
+        // Browsers always send Origin on WebSocket upgrades and do not apply
+        // CORS to them, so this is what stops other sites from listening in.
+        // Clients that are not browsers send none.
+        const QHttpHeaders headers = request.headers();
+        if (headers.contains(QHttpHeaders::WellKnownHeader::Origin))
+        {
+            const QByteArray origin = headers.value(QHttpHeaders::WellKnownHeader::Origin).toByteArray();
+            const QByteArray port = QByteArray::number(m_port);
+            bool allowed = origin == "http://localhost:" + port || origin == "http://127.0.0.1:" + port ||
+                           (!m_devOrigin.isEmpty() && origin == m_devOrigin);
+            if (!allowed)
+            {
+                qWarning() << "⚠️ Event stream upgrade from foreign origin rejected:" << origin;
+                return QHttpServerWebSocketUpgradeResponse::deny(403, "Origin not allowed");
+            }
+        }
+        if (!m_broadcaster->canAccept())
+        {
+            qWarning() << "⚠️ Event stream client limit reached - rejecting connection";
+            return QHttpServerWebSocketUpgradeResponse::deny(503, "Too many event stream clients");
+        }
+        return QHttpServerWebSocketUpgradeResponse::accept(); });
+
+    connect(m_server, &QHttpServer::newWebSocketConnection, this, [this]()
+            {
+        while (m_server->hasPendingWebSocketConnections())
+        {
+            m_broadcaster->addClient(m_server->nextPendingWebSocketConnection());
+        } });
 }
 
 void HttpServer::setupStaticRoutes()
@@ -283,64 +847,25 @@ void HttpServer::setupStaticRoutes()
         return;
     }
 
-    // Serve static files with proper routing
-    m_server->route("<arg>", [this](const QUrl &url)
+    m_assets = new StaticAssetCache(m_frontendPath, this);
+    m_assets->load();
+
+    // Serve static files from memory
+    m_server->route("<arg>", [this](const QUrl &url, const QHttpServerRequest &request)
                     {
-        QString path = url.path();
-        
         // Skip API routes
-        if (path.startsWith("/api/"))
+        if (url.path().startsWith("/api/"))
         {
             return QHttpServerResponse(QHttpServerResponse::StatusCode::NotFound);
         }
-        
-        // Default to index.html for root
-        if (path == "/" || path.isEmpty())
-        {
-            path = "/index.html";
-        }
-
-        QString filePath = m_frontendPath + path;
-        QFileInfo fileInfo(filePath);
-
-        // If file doesn't exist and no extension, try .html
-        if (!fileInfo.exists() && !path.contains("."))
-        {
-            filePath = m_frontendPath + path + ".html";
-            fileInfo.setFile(filePath);
-        }
-
-        // Try to open and serve the file
-        if (fileInfo.exists() && fileInfo.isFile())
-        {
-            QFile file(filePath);
-            if (file.open(QIODevice::ReadOnly))
-            {
-                QByteArray content = file.readAll();
-                file.close();
-                
-                QString mimeType = getMimeType(filePath);
-                
-                QHttpServerResponse response(mimeType.toUtf8(), content);
-                
-                return response;
-            }
-        }
 
-        // For client-side routing, return index.html
-        if (!path.contains("."))
+        std::shared_ptr<const StaticAsset> asset = m_assets->find(url.path());
+        if (!asset)
         {
-            QFile indexFile(m_frontendPath + "/index.html");
-            if (indexFile.open(QIODevice::ReadOnly))
-            {
-                QByteArray content = indexFile.readAll();
-                indexFile.close();
-                return QHttpServerResponse("text/html", content);
-            }
+            // 404 for missing files
+            return QHttpServerResponse(QHttpServerResponse::StatusCode::NotFound);
         }
-
-        // 404 for missing files
-        return QHttpServerResponse(QHttpServerResponse::StatusCode::NotFound); });
+        return staticAssetResponse(*asset, request); });
 
     qInfo() << "✅ Static file serving enabled from:" << m_frontendPath;
-}
\ No newline at end of file
+}
@@ -5,17 +5,41 @@
 #include <QHttpServer>
 #include <QTcpServer>
 #include <QHttpServerRequest>
+#include <QHttpServerResponse>
+#include <QHttpServerResponder>
+#include <QHttpHeaders>
+#include <QFuture>
+#include <QAtomicInt>
+#include <functional>
 #include <memory>
 
 class ActivityManager;
 class AlarmManager;
+class StaticAssetCache;
+class EventBroadcaster;
+class QThreadPool;
 
 class HttpServer : public QObject
 {
     Q_OBJECT
 
 public:
+    // Database work for API routes runs on a bounded worker pool. Requests
+    // beyond maxPendingRequests are rejected with 503 instead of queueing.
+    struct Options
+    {
+        int workerThreads = 4;
+        int maxPendingRequests = 256;
+        // Concurrent /api/stream WebSocket clients; more are refused with 503.
+        int maxStreamClients = 32;
+        // Besides the served origin, the only page origin allowed to open
+        // /api/stream (the Next dev server). Empty allows none.
+        QString devOrigin = "http://localhost:3000";
+    };
+
     explicit HttpServer(ActivityManager *activityMgr, AlarmManager *alarmMgr, QObject *parent = nullptr);
+    ~HttpServer();
+    void setOptions(const Options &options);
     bool start(quint16 port = 8080);
     void stop();
     quint16 getPort() const;
@@ -23,13 +47,26 @@ public:
 private:
     void setupRoutes();
     void setupStaticRoutes();
+    void setupEventStream();
     QJsonObject parseRequestBody(const QHttpServerRequest &request);
     QString findFrontendPath();
-    QString getMimeType(const QString &filePath);
 
     QHttpServerResponse jsonResponse(const QJsonObject &obj, QHttpServerResponse::StatusCode code = QHttpServerResponse::StatusCode::Ok);
     QHttpServerResponse jsonResponse(const QJsonArray &arr, QHttpServerResponse::StatusCode code = QHttpServerResponse::StatusCode::Ok);
     QHttpServerResponse errorResponse(const QString &message, QHttpServerResponse::StatusCode code = QHttpServerResponse::StatusCode::BadRequest);
+    // Builds the response for an {"error", "status"} result from ActivityManager.
+    QHttpServerResponse errorResponse(const QJsonObject &result);
+    bool reserveRequestSlot();
+    QFuture<QHttpServerResponse> runAsync(std::function<QHttpServerResponse()> work);
+    void respond(QHttpServerResponder &responder, QFuture<QHttpServerResponse> future);
+    void streamAllActivities(QHttpServerResponder &responder, qint64 revision);
+    // Conditional GET support for event reads: ETag and X-Data-Revision
+    // from ActivityManager::dataRevision(). The epoch keeps tags from an
+    // earlier run from matching once the counter restarts.
+    QByteArray revisionETag(qint64 revision) const;
+    QHttpHeaders revisionHeaders(qint64 revision) const;
+    QHttpServerResponse withRevision(QHttpServerResponse response, qint64 revision) const;
+    static QFuture<QHttpServerResponse> readyFuture(QHttpServerResponse &&response);
 
     QHttpServer *m_server;
     std::unique_ptr<QTcpServer> m_tcpServer;
@@ -37,6 +74,14 @@ private:
     AlarmManager *m_alarmManager;
     quint16 m_port;
     QString m_frontendPath;
+    StaticAssetCache *m_assets;
+    EventBroadcaster *m_broadcaster;
+    qint64 m_revisionEpoch;
+    QByteArray m_devOrigin;
+    QThreadPool *m_workerPool;
+    int m_maxPendingRequests;
+    QAtomicInt m_pendingRequests;
+    QAtomicInt m_stopping;
 };
 
 #endif
\ No newline at end of file
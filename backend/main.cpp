@@ -3,6 +3,7 @@
 #include "httpserver.h"
 #include "activitymanager.h"
 #include "alarmmanager.h"
+#include "notificationdispatcher.h"
 #include <QApplication>
 #include <QCoreApplication>
 #include <QDebug>
@@ -11,6 +12,11 @@ int main(int argc, char *argv[])
 {
     bool headless = false;
     quint16 port = 8080;
+    Database::Options dbOptions;
+    HttpServer::Options serverOptions;
+    ActivityManager::Options activityOptions;
+    NotificationDispatcher::Options notifyOptions;
+    AlarmManager::Options alarmOptions;
 
     for (int i = 1; i < argc; i++)
     {
@@ -23,8 +29,70 @@ int main(int argc, char *argv[])
         {
             port = arg.mid(7).toInt();
         }
+        else if (arg.startsWith("--db-cache-mb="))
+        {
+            dbOptions.cacheSizeMb = arg.mid(14).toInt();
+        }
+        else if (arg.startsWith("--db-mmap-mb="))
+        {
+            dbOptions.mmapSizeMb = arg.mid(13).toInt();
+        }
+        else if (arg.startsWith("--db-synchronous="))
+        {
+            dbOptions.synchronous = arg.mid(17);
+        }
+        else if (arg.startsWith("--db-busy-timeout-ms="))
+        {
+            dbOptions.busyTimeoutMs = arg.mid(21).toInt();
+        }
+        else if (arg.startsWith("--http-workers="))
+        {
+            serverOptions.workerThreads = arg.mid(15).toInt();
+        }
+        else if (arg.startsWith("--http-queue="))
+        {
+            serverOptions.maxPendingRequests = arg.mid(13).toInt();
+        }
+        else if (arg.startsWith("--stream-clients="))
+        {
+            serverOptions.maxStreamClients = arg.mid(17).toInt();
+        }
+        else if (arg.startsWith("--dev-origin="))
+        {
+            serverOptions.devOrigin = arg.mid(13);
+        }
+        else if (arg == "--no-event-cache")
+        {
+            activityOptions.cacheEnabled = false;
+        }
+        else if (arg.startsWith("--tombstone-retention-days="))
+        {
+            activityOptions.tombstoneRetentionDays = arg.mid(27).toInt();
+        }
+        else if (arg.startsWith("--alarm-grace-sec="))
+        {
+            alarmOptions.graceSec = arg.mid(18).toInt();
+        }
+        else if (arg.startsWith("--alarm-expiry-min="))
+        {
+            alarmOptions.expiryMin = arg.mid(19).toInt();
+        }
+        else if (arg.startsWith("--alarm-watchdog-sec="))
+        {
+            alarmOptions.watchdogSec = arg.mid(21).toInt();
+        }
+        else if (arg.startsWith("--notify-socket="))
+        {
+            notifyOptions.localSocketName = arg.mid(16);
+        }
+        else if (arg.startsWith("--notify-sound-interval-ms="))
+        {
+            notifyOptions.soundIntervalMs = arg.mid(27).toInt();
+        }
     }
 
+    Database::instance().setOptions(dbOptions);
+
     if (headless)
     {
         QCoreApplication app(argc, argv);
@@ -40,9 +108,16 @@ int main(int argc, char *argv[])
         }
 
         ActivityManager activityManager;
-        AlarmManager alarmManager;
+        activityManager.setOptions(activityOptions);
+        NotificationDispatcher notifier;
+        notifier.setOptions(notifyOptions);
+        notifier.start();
+        AlarmManager alarmManager(&activityManager, &notifier);
+        alarmManager.setOptions(alarmOptions);
+        alarmManager.start();
 
         HttpServer server(&activityManager, &alarmManager);
+        server.setOptions(serverOptions);
         if (server.start(port))
         {
             qInfo() << "✅ Backend Server started on port" << server.getPort();
@@ -50,13 +125,30 @@ int main(int argc, char *argv[])
             qInfo() << "   GET    /status";
             qInfo() << "   GET    /api/event";
             qInfo() << "   POST   /api/event";
+            qInfo() << "   GET    /api/event/changes?since=REV";
             qInfo() << "   GET    /api/event/:id";
             qInfo() << "   PUT    /api/event/:id";
             qInfo() << "   DELETE /api/event/:id";
+            qInfo() << "   WS     /api/stream";
             qInfo() << "";
             qInfo() << "💡 Usage:";
             qInfo() << "   --headless        Run backend only (no GUI)";
             qInfo() << "   --port=8080       Set backend port";
+            qInfo() << "   --db-cache-mb=16  SQLite page cache per connection (MiB)";
+            qInfo() << "   --db-mmap-mb=64   SQLite memory-mapped I/O size (MiB)";
+            qInfo() << "   --db-synchronous=NORMAL  OFF, NORMAL, FULL or EXTRA";
+            qInfo() << "   --db-busy-timeout-ms=5000  Wait time for locked database";
+            qInfo() << "   --http-workers=4  Worker threads for API requests";
+            qInfo() << "   --http-queue=256  Max pending API requests before 503";
+            qInfo() << "   --stream-clients=32  Max WebSocket clients on /api/stream";
+            qInfo() << "   --dev-origin=http://localhost:3000  Extra page origin allowed on /api/stream (empty = none)";
+            qInfo() << "   --no-event-cache  Serve reads from SQLite instead of memory";
+            qInfo() << "   --tombstone-retention-days=30  Keep deletions in the change log this long (0 = forever)";
+            qInfo() << "   --alarm-grace-sec=60  Late alarms within this still fire normally";
+            qInfo() << "   --alarm-expiry-min=1440  Drop alarms missed by longer than this (0 = never)";
+            qInfo() << "   --alarm-watchdog-sec=0  Max timer sleep, bounds lateness after suspend (0 = off)";
+            qInfo() << "   --notify-socket=NAME  Also send alarms as JSON lines to a local socket";
+            qInfo() << "   --notify-sound-interval-ms=3000  Minimum gap between alarm sounds";
             return app.exec();
         }
         else
@@ -76,7 +168,12 @@ int main(int argc, char *argv[])
 
         qInfo() << "🚀 Starting Daily Reminder (Desktop Mode)";
 
-        MainWindow window;
+        MainWindow::Options windowOptions;
+        windowOptions.server = serverOptions;
+        windowOptions.activities = activityOptions;
+        windowOptions.notifications = notifyOptions;
+        windowOptions.alarms = alarmOptions;
+        MainWindow window(windowOptions);
         window.show();
 
         return app.exec();
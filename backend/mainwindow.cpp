@@ -16,8 +16,8 @@
 #include <QApplication>
 #include <QStyle>
 
-MainWindow::MainWindow(QWidget *parent)
-    : QMainWindow(parent), m_trayIcon(nullptr), m_trayMenu(nullptr)
+MainWindow::MainWindow(const Options &options, QWidget *parent)
+    : QMainWindow(parent), m_httpServer(nullptr), m_alarmManager(nullptr), m_trayIcon(nullptr), m_trayMenu(nullptr)
 {
     setWindowTitle("Daily Activity Reminder");
     resize(1280, 800);
@@ -29,9 +29,16 @@ MainWindow::MainWindow(QWidget *parent)
     }
 
     m_activityManager = new ActivityManager(this);
-    m_alarmManager = new AlarmManager(this);
+    m_activityManager->setOptions(options.activities);
+    m_notifier = new NotificationDispatcher(this);
+    m_notifier->setOptions(options.notifications);
+    m_notifier->start();
+    m_alarmManager = new AlarmManager(m_activityManager, m_notifier);
+    m_alarmManager->setOptions(options.alarms);
+    m_alarmManager->start();
 
     m_httpServer = new HttpServer(m_activityManager, m_alarmManager, this);
+    m_httpServer->setOptions(options.server);
     if (!m_httpServer->start(8080))
     {
         qCritical() << "Failed to start HTTP server!";
@@ -40,8 +47,8 @@ MainWindow::MainWindow(QWidget *parent)
 
     setupSystemTray();
 
-    // Connect alarm manager to system tray for notifications
-    m_alarmManager->setSystemTrayIcon(m_trayIcon);
+    // Let alarm notifications use the system tray
+    m_notifier->setSystemTrayIcon(m_trayIcon);
 
     setupWebView();
 }
@@ -52,6 +59,8 @@ MainWindow::~MainWindow()
     {
         m_httpServer->stop();
     }
+    // Not a child: it lives on its own thread until stopped.
+    delete m_alarmManager;
     if (m_trayIcon)
     {
         delete m_trayIcon;
@@ -5,17 +5,25 @@
 #include <QWebEngineView>
 #include <QSystemTrayIcon>
 #include <QMenu>
-
-class HttpServer;
-class ActivityManager;
-class AlarmManager;
+#include "httpserver.h"
+#include "activitymanager.h"
+#include "notificationdispatcher.h"
+#include "alarmmanager.h"
 
 class MainWindow : public QMainWindow
 {
     Q_OBJECT
 
 public:
-    MainWindow(QWidget *parent = nullptr);
+    struct Options
+    {
+        HttpServer::Options server;
+        ActivityManager::Options activities;
+        NotificationDispatcher::Options notifications;
+        AlarmManager::Options alarms;
+    };
+
+    explicit MainWindow(const Options &options, QWidget *parent = nullptr);
     ~MainWindow();
 
 protected:
@@ -33,6 +41,7 @@ private:
     QWebEngineView *m_webView;
     HttpServer *m_httpServer;
     ActivityManager *m_activityManager;
+    NotificationDispatcher *m_notifier;
     AlarmManager *m_alarmManager;
     QSystemTrayIcon *m_trayIcon;
     QMenu *m_trayMenu;
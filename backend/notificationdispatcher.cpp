@@ -0,0 +1,333 @@
+#include "notificationdispatcher.h"
+#include <QThread>
+#include <QGuiApplication>
+#include <QProcess>
+#include <QFile>
+#include <QStandardPaths>
+#include <QLocalSocket>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QDebug>
+
+namespace
+{
+    class LogSink : public NotificationSink
+    {
+    public:
+        QString name() const override { return "log"; }
+        bool probe() override { return true; }
+
+        void deliver(const Notification &notification) override
+        {
+            qInfo() << "🔔 ================================";
+            qInfo() << "🔔 ALARM NOTIFICATION";
+            qInfo() << "🔔 Event ID:" << notification.eventId;
+            qInfo() << "🔔" << notification.heading;
+            for (const QString &line : notification.message.split('\n'))
+            {
+                qInfo() << "🔔" << line;
+            }
+            qInfo() << "🔔 ================================";
+        }
+    };
+
+    // notify-send on Linux, osascript on macOS. Windows relies on the tray.
+    class DesktopSink : public NotificationSink
+    {
+    public:
+        QString name() const override { return "desktop"; }
+
+        bool probe() override
+        {
+#if defined(Q_OS_LINUX)
+            m_program = QStandardPaths::findExecutable("notify-send");
+#elif defined(Q_OS_MACOS)
+            m_program = QStandardPaths::findExecutable("osascript");
+#endif
+            return !m_program.isEmpty();
+        }
+
+        void deliver(const Notification &notification) override
+        {
+#if defined(Q_OS_MACOS)
+            QString message = notification.message;
+            QString heading = notification.heading;
+            QString script = QString("display notification \"%1\" with title \"%2\" sound name \"default\"")
+                                 .arg(message.replace("\"", "\\\""), heading.replace("\"", "\\\""));
+            QProcess::startDetached(m_program, QStringList() << "-e" << script);
+#else
+            QProcess::startDetached(m_program,
+                                    QStringList() << "-u" << "critical"
+                                                  << "-i" << "appointment-soon"
+                                                  << "-t" << "10000" // Show for 10 seconds
+                                                  << notification.heading
+                                                  << notification.message);
+#endif
+        }
+
+    private:
+        QString m_program;
+    };
+
+    class TraySink : public NotificationSink
+    {
+    public:
+        explicit TraySink(NotificationDispatcher *dispatcher) : m_dispatcher(dispatcher) {}
+
+        QString name() const override { return "tray"; }
+        bool probe() override { return QSystemTrayIcon::isSystemTrayAvailable(); }
+
+        void deliver(const Notification &notification) override
+        {
+            QPointer<QSystemTrayIcon> trayIcon = m_dispatcher->systemTrayIcon();
+            if (!trayIcon)
+            {
+                return;
+            }
+
+            // The icon belongs to the GUI thread; the icon is also the
+            // context object, so the call is dropped if it is destroyed.
+            QSystemTrayIcon *icon = trayIcon.data();
+            QMetaObject::invokeMethod(icon, [icon, notification]()
+                                      {
+                if (icon->isVisible() && icon->supportsMessages())
+                {
+                    icon->showMessage(notification.heading, notification.message, QSystemTrayIcon::Information, 10000);
+                } }, Qt::QueuedConnection);
+        }
+
+    private:
+        NotificationDispatcher *m_dispatcher;
+    };
+
+    // The player and sound file are chosen once by probe() instead of being
+    // looked up on every alarm.
+    class SoundSink : public NotificationSink
+    {
+    public:
+        QString name() const override { return "sound"; }
+
+        bool probe() override
+        {
+#if defined(Q_OS_LINUX)
+            const QStringList soundFiles = {
+                "/usr/share/sounds/freedesktop/stereo/alarm-clock-elapsed.oga",
+                "/usr/share/sounds/freedesktop/stereo/complete.oga",
+                "/usr/share/sounds/freedesktop/stereo/bell.oga",
+                "/usr/share/sounds/sound-icons/xylofon.wav"};
+
+            for (const char *player : {"paplay", "aplay"})
+            {
+                QString program = QStandardPaths::findExecutable(player);
+                if (program.isEmpty())
+                {
+                    continue;
+                }
+                for (const QString &soundFile : soundFiles)
+                {
+                    if (QFile::exists(soundFile))
+                    {
+                        m_program = program;
+                        m_arguments = QStringList() << soundFile;
+                        return true;
+                    }
+                }
+            }
+
+            m_program = QStandardPaths::findExecutable("beep");
+            m_arguments = QStringList() << "-f" << "1000" << "-l" << "500" << "-r" << "3";
+#elif defined(Q_OS_MACOS)
+            m_program = QStandardPaths::findExecutable("afplay");
+            m_arguments = QStringList() << "/System/Library/Sounds/Glass.aiff";
+#elif defined(Q_OS_WIN)
+            m_program = QStandardPaths::findExecutable("powershell");
+            m_arguments = QStringList() << "-Command" << "[console]::beep(1000,500)";
+#endif
+            return !m_program.isEmpty();
+        }
+
+        void deliver(const Notification &) override
+        {
+            QProcess::startDetached(m_program, m_arguments);
+        }
+
+    private:
+        QString m_program;
+        QStringList m_arguments;
+    };
+
+    // Writes each notification as one JSON line to a local server, for
+    // integrations that want to react to alarms.
+    class LocalSocketSink : public NotificationSink
+    {
+    public:
+        explicit LocalSocketSink(const QString &serverName) : m_serverName(serverName) {}
+
+        QString name() const override { return "local-socket"; }
+        bool probe() override { return !m_serverName.isEmpty(); }
+
+        void deliver(const Notification &notification) override
+        {
+            QLocalSocket socket;
+            socket.connectToServer(m_serverName, QIODevice::WriteOnly);
+            if (!socket.waitForConnected(200))
+            {
+                return;
+            }
+
+            QJsonObject payload{
+                {"eventId", notification.eventId},
+                {"title", notification.heading},
+                {"message", notification.message},
+                {"firedAt", notification.firedAt.toString(Qt::ISODateWithMs)}};
+            socket.write(QJsonDocument(payload).toJson(QJsonDocument::Compact) + '\n');
+            socket.waitForBytesWritten(200);
+            socket.disconnectFromServer();
+        }
+
+    private:
+        QString m_serverName;
+    };
+}
+
+NotificationDispatcher::NotificationDispatcher(QObject *parent)
+    : QObject(parent), m_worker(nullptr), m_stopping(false)
+{
+}
+
+NotificationDispatcher::~NotificationDispatcher()
+{
+    stop();
+}
+
+void NotificationDispatcher::setOptions(const Options &options)
+{
+    m_options = options;
+}
+
+void NotificationDispatcher::setSystemTrayIcon(QSystemTrayIcon *trayIcon)
+{
+    QMutexLocker locker(&m_mutex);
+    m_trayIcon = trayIcon;
+}
+
+QPointer<QSystemTrayIcon> NotificationDispatcher::systemTrayIcon()
+{
+    QMutexLocker locker(&m_mutex);
+    return m_trayIcon;
+}
+
+void NotificationDispatcher::addSink(std::unique_ptr<NotificationSink> sink, int minIntervalMs)
+{
+    m_sinks.push_back(SinkEntry{std::move(sink), minIntervalMs, QElapsedTimer()});
+}
+
+void NotificationDispatcher::start()
+{
+    if (m_worker)
+    {
+        return;
+    }
+
+    addSink(std::make_unique<LogSink>());
+    // --headless runs on a QCoreApplication: there is no desktop session to
+    // notify, and probing the tray without a QGuiApplication asserts.
+    if (qobject_cast<QGuiApplication *>(QCoreApplication::instance()))
+    {
+        addSink(std::make_unique<DesktopSink>(), m_options.desktopIntervalMs);
+        addSink(std::make_unique<TraySink>(this), m_options.desktopIntervalMs);
+        addSink(std::make_unique<SoundSink>(), m_options.soundIntervalMs);
+    }
+    addSink(std::make_unique<LocalSocketSink>(m_options.localSocketName));
+
+    QStringList available;
+    for (auto it = m_sinks.begin(); it != m_sinks.end();)
+    {
+        if (it->sink->probe())
+        {
+            available << it->sink->name();
+            ++it;
+        }
+        else
+        {
+            it = m_sinks.erase(it);
+        }
+    }
+    qInfo() << "🔔 Notification sinks:" << available.join(", ");
+
+    m_worker = QThread::create([this]()
+                               { run(); });
+    m_worker->setObjectName("notification-dispatcher");
+    m_worker->start();
+}
+
+void NotificationDispatcher::stop()
+{
+    if (!m_worker)
+    {
+        return;
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stopping = true;
+        m_queueChanged.wakeAll();
+    }
+    m_worker->wait();
+    delete m_worker;
+    m_worker = nullptr;
+}
+
+void NotificationDispatcher::post(const Notification &notification)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_queue.size() >= m_options.maxQueued)
+    {
+        qWarning() << "⚠️ Notification queue full - dropping oldest notification";
+        m_queue.dequeue();
+    }
+    m_queue.enqueue(notification);
+    m_queueChanged.wakeOne();
+}
+
+void NotificationDispatcher::run()
+{
+    for (;;)
+    {
+        Notification notification;
+        {
+            QMutexLocker locker(&m_mutex);
+            while (m_queue.isEmpty() && !m_stopping)
+            {
+                m_queueChanged.wait(&m_mutex);
+            }
+            if (m_queue.isEmpty())
+            {
+                return;
+            }
+            notification = m_queue.dequeue();
+        }
+
+        deliver(notification);
+    }
+}
+
+void NotificationDispatcher::deliver(const Notification &notification)
+{
+    for (SinkEntry &entry : m_sinks)
+    {
+        if (entry.minIntervalMs > 0 && entry.lastDelivery.isValid() && entry.lastDelivery.elapsed() < entry.minIntervalMs)
+        {
+            entry.dropped++;
+            continue;
+        }
+
+        if (entry.dropped > 0)
+        {
+            qInfo() << "🔕" << entry.sink->name() << "skipped" << entry.dropped << "notification(s) (rate limited)";
+            entry.dropped = 0;
+        }
+        entry.sink->deliver(notification);
+        entry.lastDelivery.start();
+    }
+}
@@ -0,0 +1,96 @@
+#ifndef NOTIFICATIONDISPATCHER_H
+#define NOTIFICATIONDISPATCHER_H
+
+#include <QObject>
+#include <QString>
+#include <QDateTime>
+#include <QQueue>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QSystemTrayIcon>
+#include <memory>
+#include <vector>
+
+class QThread;
+
+struct Notification
+{
+    QString eventId;
+    QString heading;
+    QString message;
+    QDateTime firedAt;
+};
+
+// A notification target. probe() runs once when the dispatcher starts and
+// decides whether the sink is used at all; deliver() runs on the worker.
+class NotificationSink
+{
+public:
+    virtual ~NotificationSink() = default;
+    virtual QString name() const = 0;
+    virtual bool probe() = 0;
+    virtual void deliver(const Notification &notification) = 0;
+};
+
+// Queues notifications and hands them to every available sink on a
+// dedicated worker thread, so alarm firing never waits on process spawns
+// or socket writes.
+class NotificationDispatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Interval options are per-sink rate limits: deliveries that arrive
+    // sooner than this after the previous one are dropped for that sink.
+    struct Options
+    {
+        int soundIntervalMs = 3000;
+        int desktopIntervalMs = 0;
+        // When set, each notification is also written as a JSON line to
+        // this QLocalServer name.
+        QString localSocketName;
+        int maxQueued = 256;
+    };
+
+    explicit NotificationDispatcher(QObject *parent = nullptr);
+    ~NotificationDispatcher();
+
+    void setOptions(const Options &options);
+    void setSystemTrayIcon(QSystemTrayIcon *trayIcon);
+    QPointer<QSystemTrayIcon> systemTrayIcon();
+
+    // Registers an extra sink; must be called before start().
+    void addSink(std::unique_ptr<NotificationSink> sink, int minIntervalMs = 0);
+    // Probes the sinks and starts the worker thread.
+    void start();
+    void stop();
+
+    // Thread-safe; never blocks on delivery.
+    void post(const Notification &notification);
+
+private:
+    struct SinkEntry
+    {
+        std::unique_ptr<NotificationSink> sink;
+        int minIntervalMs;
+        QElapsedTimer lastDelivery;
+        int dropped = 0;
+    };
+
+    void run();
+    void deliver(const Notification &notification);
+
+    Options m_options;
+    std::vector<SinkEntry> m_sinks;
+    QThread *m_worker;
+
+    QMutex m_mutex;
+    QWaitCondition m_queueChanged;
+    QQueue<Notification> m_queue;
+    bool m_stopping;
+    QPointer<QSystemTrayIcon> m_trayIcon;
+};
+
+#endif
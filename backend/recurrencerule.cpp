@@ -0,0 +1,233 @@
+#include "recurrencerule.h"
+#include "database.h"
+#include <QStringList>
+#include <QTimeZone>
+#include <algorithm>
+
+namespace
+{
+    constexpr qint64 msPerDay = 24LL * 60 * 60 * 1000;
+
+    // Stops a malformed rule from looping forever while skipping exceptions.
+    constexpr int maxOccurrenceSteps = 100000;
+}
+
+std::optional<RecurrenceRule> RecurrenceRule::parse(const QString &text, QString *error)
+{
+    auto fail = [error](const QString &message) -> std::optional<RecurrenceRule>
+    {
+        if (error)
+        {
+            *error = message;
+        }
+        return std::nullopt;
+    };
+
+    RecurrenceRule rule;
+    bool hasFrequency = false;
+    QString body = text.trimmed();
+    if (body.startsWith("RRULE:", Qt::CaseInsensitive))
+    {
+        body = body.mid(6);
+    }
+
+    for (const QString &part : body.split(';', Qt::SkipEmptyParts))
+    {
+        const QString key = part.section('=', 0, 0).trimmed().toUpper();
+        const QString value = part.section('=', 1).trimmed();
+        bool ok = true;
+
+        if (key == "FREQ")
+        {
+            const QString frequency = value.toUpper();
+            if (frequency == "DAILY")
+                rule.m_frequency = Frequency::Daily;
+            else if (frequency == "WEEKLY")
+                rule.m_frequency = Frequency::Weekly;
+            else if (frequency == "MONTHLY")
+                rule.m_frequency = Frequency::Monthly;
+            else
+                return fail(QString("Unsupported recurrence frequency: %1").arg(value));
+            hasFrequency = true;
+        }
+        else if (key == "INTERVAL")
+        {
+            rule.m_interval = value.toInt(&ok);
+            if (!ok || rule.m_interval < 1)
+                return fail("INTERVAL must be a positive integer");
+        }
+        else if (key == "COUNT")
+        {
+            rule.m_count = value.toInt(&ok);
+            if (!ok || rule.m_count < 1)
+                return fail("COUNT must be a positive integer");
+        }
+        else if (key == "UNTIL")
+        {
+            // iCalendar basic format, or ISO 8601 as used everywhere else.
+            QDateTime until = QDateTime::fromString(value, "yyyyMMdd'T'HHmmss'Z'");
+            if (until.isValid())
+            {
+                until.setTimeZone(QTimeZone::UTC);
+            }
+            else
+            {
+                until = Database::parseDateTime(value);
+            }
+            if (!until.isValid())
+                return fail("UNTIL must be a date-time");
+            rule.m_untilMs = until.toMSecsSinceEpoch();
+        }
+        else
+        {
+            return fail(QString("Unsupported recurrence rule part: %1").arg(key));
+        }
+    }
+
+    if (!hasFrequency)
+    {
+        return fail("Recurrence rule needs FREQ");
+    }
+    return rule;
+}
+
+QSet<qint64> RecurrenceRule::parseExceptions(const QString &text, bool *ok)
+{
+    QSet<qint64> exceptions;
+    if (ok)
+    {
+        *ok = true;
+    }
+
+    for (const QString &entry : text.split(',', Qt::SkipEmptyParts))
+    {
+        QVariant ms = Database::toEpochMs(entry.trimmed());
+        if (ms.isNull())
+        {
+            if (ok)
+            {
+                *ok = false;
+            }
+            continue;
+        }
+        exceptions.insert(ms.toLongLong());
+    }
+    return exceptions;
+}
+
+QList<QDateTime> RecurrenceRule::occurrences(const QDateTime &seriesStart, qint64 durationMs, qint64 fromMs, qint64 toMs,
+                                             const QSet<qint64> &exceptions, int limit) const
+{
+    QList<QDateTime> result;
+    for (qint64 index = indexBefore(seriesStart, fromMs - durationMs), steps = 0;
+         result.size() < limit && steps < maxOccurrenceSteps; ++index, ++steps)
+    {
+        QDateTime start = occurrence(seriesStart, index);
+        qint64 startMs = start.toMSecsSinceEpoch();
+        if (!inSeries(index, start) || startMs > toMs)
+        {
+            break;
+        }
+        if (startMs + durationMs >= fromMs && !exceptions.contains(startMs))
+        {
+            result.append(start);
+        }
+    }
+    return result;
+}
+
+std::optional<QDateTime> RecurrenceRule::nextOccurrence(const QDateTime &seriesStart, qint64 afterMs, const QSet<qint64> &exceptions) const
+{
+    for (qint64 index = indexBefore(seriesStart, afterMs), steps = 0; steps < maxOccurrenceSteps; ++index, ++steps)
+    {
+        QDateTime start = occurrence(seriesStart, index);
+        if (!inSeries(index, start))
+        {
+            break;
+        }
+        qint64 startMs = start.toMSecsSinceEpoch();
+        if (startMs > afterMs && !exceptions.contains(startMs))
+        {
+            return start;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<QDateTime> RecurrenceRule::lastOccurrence(const QDateTime &seriesStart) const
+{
+    if (m_count == 0 && !m_untilMs)
+    {
+        return std::nullopt;
+    }
+
+    qint64 index = m_count > 0 ? m_count - 1 : indexBefore(seriesStart, *m_untilMs) + 2;
+    if (m_untilMs)
+    {
+        index = std::min(index, indexBefore(seriesStart, *m_untilMs) + 2);
+    }
+    for (; index >= 0; --index)
+    {
+        QDateTime start = occurrence(seriesStart, index);
+        if (inSeries(index, start))
+        {
+            return start;
+        }
+    }
+    return std::nullopt;
+}
+
+QDateTime RecurrenceRule::occurrence(const QDateTime &seriesStart, qint64 index) const
+{
+    // Always step from the series start so monthly clamping does not drift.
+    const qint64 steps = index * m_interval;
+    switch (m_frequency)
+    {
+    case Frequency::Daily:
+        return seriesStart.addDays(steps);
+    case Frequency::Weekly:
+        return seriesStart.addDays(steps * 7);
+    case Frequency::Monthly:
+        return seriesStart.addMonths(int(steps));
+    }
+    return seriesStart;
+}
+
+qint64 RecurrenceRule::indexBefore(const QDateTime &seriesStart, qint64 ms) const
+{
+    // An estimate one step early, so DST shifts and short months never make
+    // the caller skip an occurrence.
+    const qint64 startMs = seriesStart.toMSecsSinceEpoch();
+    if (ms <= startMs)
+    {
+        return 0;
+    }
+
+    qint64 index = 0;
+    switch (m_frequency)
+    {
+    case Frequency::Daily:
+        index = (ms - startMs) / (msPerDay * m_interval);
+        break;
+    case Frequency::Weekly:
+        index = (ms - startMs) / (msPerDay * 7 * m_interval);
+        break;
+    case Frequency::Monthly:
+    {
+        QDate from = seriesStart.date();
+        QDate to = QDateTime::fromMSecsSinceEpoch(ms, seriesStart.timeZone()).date();
+        index = ((to.year() - from.year()) * 12 + (to.month() - from.month())) / m_interval;
+        break;
+    }
+    }
+    return std::max<qint64>(0, index - 1);
+}
+
+bool RecurrenceRule::inSeries(qint64 index, const QDateTime &start) const
+{
+    if (m_count > 0 && index >= m_count)
+    {
+        return false;
+    }
+    return !m_untilMs || start.toMSecsSinceEpoch() <= *m_untilMs;
+}
@@ -0,0 +1,50 @@
+#ifndef RECURRENCERULE_H
+#define RECURRENCERULE_H
+
+#include <QString>
+#include <QDateTime>
+#include <QList>
+#include <QSet>
+#include <optional>
+
+// The RRULE subset used for recurring events: FREQ=DAILY|WEEKLY|MONTHLY with
+// optional INTERVAL, COUNT and UNTIL, e.g. "FREQ=WEEKLY;INTERVAL=2;COUNT=10".
+// Occurrences step the series start in its own time spec, so a series at
+// 09:00 local time stays at 09:00 across DST changes. Monthly series on the
+// 29th-31st fall on the last day of shorter months.
+class RecurrenceRule
+{
+public:
+    enum class Frequency
+    {
+        Daily,
+        Weekly,
+        Monthly
+    };
+
+    static std::optional<RecurrenceRule> parse(const QString &text, QString *error = nullptr);
+    // Parses an EXDATE-style comma-separated list of ISO 8601 occurrence
+    // starts into epoch ms. Sets *ok to false if any entry is unparsable.
+    static QSet<qint64> parseExceptions(const QString &text, bool *ok = nullptr);
+
+    // Starts of the occurrences overlapping [fromMs, toMs], skipping
+    // exceptions, in order and at most limit of them.
+    QList<QDateTime> occurrences(const QDateTime &seriesStart, qint64 durationMs, qint64 fromMs, qint64 toMs,
+                                 const QSet<qint64> &exceptions, int limit) const;
+    // First occurrence starting after afterMs that is not an exception.
+    std::optional<QDateTime> nextOccurrence(const QDateTime &seriesStart, qint64 afterMs, const QSet<qint64> &exceptions) const;
+    // Start of the last occurrence, or nullopt when the series is unbounded.
+    std::optional<QDateTime> lastOccurrence(const QDateTime &seriesStart) const;
+
+private:
+    QDateTime occurrence(const QDateTime &seriesStart, qint64 index) const;
+    qint64 indexBefore(const QDateTime &seriesStart, qint64 ms) const;
+    bool inSeries(qint64 index, const QDateTime &start) const;
+
+    Frequency m_frequency = Frequency::Daily;
+    int m_interval = 1;
+    int m_count = 0; // 0 means no COUNT limit
+    std::optional<qint64> m_untilMs;
+};
+
+#endif
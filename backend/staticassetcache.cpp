@@ -0,0 +1,291 @@
+#include "staticassetcache.h"
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QResource>
+#include <QFileSystemWatcher>
+#include <QTimer>
+#include <QMimeDatabase>
+#include <QCryptographicHash>
+#include <QDebug>
+
+namespace
+{
+    // Rebuilds trigger bursts of change signals; reload once they settle.
+    constexpr int reloadDelayMs = 300;
+
+    // How often a missing root is checked for; nothing can watch a path
+    // that does not exist.
+    constexpr int rootPollMs = 2000;
+
+    // Smaller files are not worth a compressed copy.
+    constexpr qsizetype minCompressibleBytes = 1024;
+
+    bool isCompressible(const QByteArray &mimeType)
+    {
+        return mimeType.startsWith("text/") || mimeType == "application/javascript" || mimeType == "application/json" ||
+               mimeType == "image/svg+xml" || mimeType == "application/xml" || mimeType == "application/manifest+json";
+    }
+
+    // qCompress output is a zlib stream behind a 4-byte length prefix, and a
+    // zlib stream is exactly what HTTP calls "deflate".
+    QByteArray deflate(const QByteArray &data)
+    {
+        QByteArray compressed = qCompress(data, 9);
+        compressed.remove(0, 4);
+        return compressed;
+    }
+}
+
+StaticAssetCache::StaticAssetCache(const QString &rootPath, QObject *parent)
+    : QObject(parent), m_rootPath(isEmbedded(rootPath) ? rootPath : QDir(rootPath).absolutePath())
+{
+    m_watcher = new QFileSystemWatcher(this);
+    m_reloadTimer = new QTimer(this);
+    m_reloadTimer->setSingleShot(true);
+    m_reloadTimer->setInterval(reloadDelayMs);
+
+    m_rootPollTimer = new QTimer(this);
+    m_rootPollTimer->setInterval(rootPollMs);
+
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, [this](const QString &path)
+            {
+        // A rebuild that replaces the root drops its watch; put it back on
+        // the new directory so files landing in it are still noticed.
+        if (path == m_rootPath && !m_watcher->directories().contains(m_rootPath) && QFileInfo::exists(m_rootPath))
+        {
+            m_watcher->addPath(m_rootPath);
+        }
+        m_reloadTimer->start(); });
+    connect(m_watcher, &QFileSystemWatcher::fileChanged, m_reloadTimer, qOverload<>(&QTimer::start));
+    connect(m_rootPollTimer, &QTimer::timeout, this, [this]()
+            {
+        if (QFileInfo::exists(m_rootPath))
+        {
+            m_rootPollTimer->stop();
+            m_reloadTimer->start();
+        } });
+    connect(m_reloadTimer, &QTimer::timeout, this, [this]()
+            {
+        qInfo() << "🔄 Frontend files changed - reloading static assets";
+        load(); });
+}
+
+QString StaticAssetCache::mimeTypeFor(const QString &filePath)
+{
+    // Override for specific extensions that might not be detected correctly
+    if (filePath.endsWith(".js") || filePath.endsWith(".mjs"))
+        return "application/javascript";
+    if (filePath.endsWith(".css"))
+        return "text/css";
+    if (filePath.endsWith(".html"))
+        return "text/html";
+    if (filePath.endsWith(".json"))
+        return "application/json";
+    if (filePath.endsWith(".svg"))
+        return "image/svg+xml";
+    if (filePath.endsWith(".woff2"))
+        return "font/woff2";
+    if (filePath.endsWith(".woff"))
+        return "font/woff";
+
+    QMimeDatabase mimeDb;
+    return mimeDb.mimeTypeForFile(filePath, QMimeDatabase::MatchExtension).name();
+}
+
+void StaticAssetCache::load()
+{
+    // `next build` deletes and recreates the export. Until it is back, keep
+    // serving the previous assets and watch for the root to reappear.
+    if (!isEmbedded(m_rootPath) && !QFile::exists(m_rootPath + "/index.html"))
+    {
+        qWarning() << "⚠️ Frontend export missing or incomplete - keeping" << m_assets.size() << "cached asset(s)";
+        watchTree();
+        return;
+    }
+
+    QHash<QString, std::shared_ptr<StaticAsset>> loaded;
+    QHash<QString, QByteArray> variants;
+    const QDir root(m_rootPath);
+    qsizetype totalBytes = 0;
+
+    QDirIterator it(m_rootPath, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext())
+    {
+        const QString filePath = it.next();
+        QByteArray data;
+        if (!readAsset(filePath, &data))
+        {
+            qWarning() << "⚠️ Cannot read static asset:" << filePath;
+            continue;
+        }
+
+        const QString urlPath = "/" + root.relativeFilePath(filePath);
+        totalBytes += data.size();
+        if (urlPath.endsWith(".br") || urlPath.endsWith(".gz"))
+        {
+            variants.insert(urlPath, data);
+            continue;
+        }
+
+        auto asset = std::make_shared<StaticAsset>();
+        asset->body = data;
+        asset->mimeType = mimeTypeFor(filePath).toUtf8();
+        asset->etag = '"' + QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex().left(24) + '"';
+        asset->immutable = urlPath.startsWith("/_next/static/");
+        loaded.insert(urlPath, asset);
+    }
+
+    for (auto variant = variants.constBegin(); variant != variants.constEnd(); ++variant)
+    {
+        auto base = loaded.find(variant.key().chopped(3));
+        if (base == loaded.end())
+        {
+            // A plain .gz/.br download with no uncompressed sibling.
+            auto asset = std::make_shared<StaticAsset>();
+            asset->body = variant.value();
+            asset->mimeType = mimeTypeFor(variant.key()).toUtf8();
+            asset->etag = '"' + QCryptographicHash::hash(variant.value(), QCryptographicHash::Sha1).toHex().left(24) + '"';
+            loaded.insert(variant.key(), asset);
+        }
+        else if (variant.key().endsWith(".br"))
+        {
+            (*base)->brotli = variant.value();
+        }
+        else
+        {
+            (*base)->gzip = variant.value();
+        }
+    }
+
+    if (loaded.isEmpty())
+    {
+        qWarning() << "⚠️ No static assets read from" << m_rootPath << "- keeping" << m_assets.size() << "cached asset(s)";
+        watchTree();
+        return;
+    }
+
+    int compressedCount = 0;
+    m_assets.clear();
+    for (auto asset = loaded.begin(); asset != loaded.end(); ++asset)
+    {
+        StaticAsset &entry = *asset.value();
+        if (entry.brotli.isEmpty() && entry.gzip.isEmpty() && entry.body.size() >= minCompressibleBytes && isCompressible(entry.mimeType))
+        {
+            QByteArray compressed = deflate(entry.body);
+            if (compressed.size() < entry.body.size() * 9 / 10)
+            {
+                entry.deflate = compressed;
+            }
+        }
+        if (!entry.brotli.isEmpty() || !entry.gzip.isEmpty() || !entry.deflate.isEmpty())
+        {
+            compressedCount++;
+        }
+        m_assets.insert(asset.key(), asset.value());
+    }
+
+    qInfo() << "📦 Cached" << m_assets.size() << "static asset(s)," << totalBytes / 1024 << "KB read,"
+            << compressedCount << "with compressed variants";
+    watchTree();
+}
+
+bool StaticAssetCache::isEmbedded(const QString &rootPath)
+{
+    return rootPath.startsWith(":/");
+}
+
+bool StaticAssetCache::readAsset(const QString &filePath, QByteArray *data)
+{
+    // Uncompressed resources already live in the binary's read-only data
+    // and are used in place; compressed ones are inflated once, here.
+    if (isEmbedded(filePath))
+    {
+        QResource resource(filePath);
+        if (!resource.isValid())
+        {
+            return false;
+        }
+        *data = resource.compressionAlgorithm() == QResource::NoCompression
+                    ? QByteArray::fromRawData(reinterpret_cast<const char *>(resource.data()), resource.size())
+                    : resource.uncompressedData();
+        return true;
+    }
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+    *data = file.readAll();
+    return true;
+}
+
+std::shared_ptr<const StaticAsset> StaticAssetCache::find(const QString &urlPath) const
+{
+    QString path = urlPath;
+    // Default to index.html for root
+    if (path == "/" || path.isEmpty())
+    {
+        path = "/index.html";
+    }
+
+    if (auto asset = m_assets.value(path))
+    {
+        return asset;
+    }
+    if (path.contains('.'))
+    {
+        return nullptr;
+    }
+    if (auto asset = m_assets.value(path + ".html"))
+    {
+        return asset;
+    }
+    // For client-side routing, return index.html
+    return m_assets.value("/index.html");
+}
+
+void StaticAssetCache::watchTree()
+{
+    // Resources are fixed at build time.
+    if (isEmbedded(m_rootPath))
+    {
+        return;
+    }
+
+    if (!m_watcher->directories().isEmpty())
+    {
+        m_watcher->removePaths(m_watcher->directories());
+    }
+    if (!m_watcher->files().isEmpty())
+    {
+        m_watcher->removePaths(m_watcher->files());
+    }
+
+    if (!QFileInfo::exists(m_rootPath))
+    {
+        m_rootPollTimer->start();
+        return;
+    }
+    m_rootPollTimer->stop();
+
+    // Directory watches see files being added, removed or replaced. Hashed
+    // chunks are never edited in place, so only the other files are watched
+    // individually, which keeps the watch count small.
+    QStringList paths{m_rootPath};
+    QDirIterator dirs(m_rootPath, QDir::Dirs | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while (dirs.hasNext())
+    {
+        paths << dirs.next();
+    }
+    for (auto asset = m_assets.constBegin(); asset != m_assets.constEnd(); ++asset)
+    {
+        if (!asset.value()->immutable)
+        {
+            paths << m_rootPath + asset.key();
+        }
+    }
+    m_watcher->addPaths(paths);
+}
@@ -0,0 +1,62 @@
+#ifndef STATICASSETCACHE_H
+#define STATICASSETCACHE_H
+
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+#include <QHash>
+#include <memory>
+
+class QFileSystemWatcher;
+class QTimer;
+
+// One frontend file held in memory with everything needed to answer a
+// request: MIME type, strong ETag and any compressed variants.
+struct StaticAsset
+{
+    QByteArray body;
+    QByteArray mimeType;
+    QByteArray etag;
+    // Precompressed siblings (<file>.br / <file>.gz) from the build, and a
+    // deflate copy made at load time for compressible files without them.
+    QByteArray brotli;
+    QByteArray gzip;
+    QByteArray deflate;
+    // Content-hashed Next.js chunks under /_next/static/ never change.
+    bool immutable = false;
+};
+
+// Loads the exported frontend once and serves it from memory. The tree is
+// reloaded, debounced, when QFileSystemWatcher reports a change, so a new
+// `npm run build` is picked up without restarting; while the root is gone
+// mid-build it is polled for instead. A ":/" root reads the
+// bundle compiled in with EMBED_FRONTEND instead, which is never reloaded.
+// Used only from the thread that owns it (the HTTP server's).
+class StaticAssetCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit StaticAssetCache(const QString &rootPath, QObject *parent = nullptr);
+
+    void load();
+    // Resolves a URL path the way the export expects: the exact file, then
+    // "<path>.html", then index.html for extensionless client-side routes.
+    std::shared_ptr<const StaticAsset> find(const QString &urlPath) const;
+    bool isEmpty() const { return m_assets.isEmpty(); }
+
+    static QString mimeTypeFor(const QString &filePath);
+
+private:
+    static bool isEmbedded(const QString &rootPath);
+    static bool readAsset(const QString &filePath, QByteArray *data);
+    void watchTree();
+
+    QString m_rootPath;
+    QHash<QString, std::shared_ptr<const StaticAsset>> m_assets;
+    QFileSystemWatcher *m_watcher;
+    QTimer *m_reloadTimer;
+    QTimer *m_rootPollTimer;
+};
+
+#endif
@@ -73,6 +73,7 @@ EOF
 cmake -DCMAKE_TOOLCHAIN_FILE=mingw-toolchain.cmake \
       -DCMAKE_BUILD_TYPE=Release \
       -DCMAKE_PREFIX_PATH="$QT_WIN_PATH" \
+      -DEMBED_FRONTEND="${EMBED_FRONTEND:-OFF}" \
       ..
 
 cmake --build . -j$(nproc)
@@ -87,8 +88,10 @@ mkdir -p "$OUTPUT_DIR/DailyReminder"
 # Copy backend executable
 cp backend/build-windows/backend.exe "$OUTPUT_DIR/DailyReminder/"
 
-# Copy frontend
-cp -r frontend/out "$OUTPUT_DIR/DailyReminder/frontend"
+# Copy frontend (not needed when it is embedded in the executable)
+if [ "${EMBED_FRONTEND:-OFF}" != "ON" ]; then
+    cp -r frontend/out "$OUTPUT_DIR/DailyReminder/frontend"
+fi
 
 # 4. Copy Qt DLLs (manual since windeployqt doesn't work on Linux)
 echo ""
@@ -100,10 +103,12 @@ QT_DLLS=(
     "Qt6Widgets.dll"
     "Qt6Network.dll"
     "Qt6Sql.dll"
+    "Qt6Concurrent.dll"
     "Qt6WebEngineCore.dll"
     "Qt6WebEngineWidgets.dll"
     "Qt6WebChannel.dll"
     "Qt6HttpServer.dll"
+    "Qt6WebSockets.dll"
     "Qt6Qml.dll"
     "Qt6QmlModels.dll"
     "Qt6Quick.dll"
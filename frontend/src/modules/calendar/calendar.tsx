@@ -5,11 +5,12 @@ import { CalendarBody } from "@/modules/calendar/calendar-body";
 import { CalendarProvider } from "@/modules/calendar/contexts/calendar-context";
 import { DndProvider } from "@/modules/calendar/contexts/dnd-context";
 import { CalendarHeader } from "@/modules/calendar/header/calendar-header";
-import { getEvents } from "@/modules/calendar/requests";
+import { getEventsSnapshot } from "@/modules/calendar/requests";
 import type { IEvent } from "@/modules/calendar/interfaces";
 
 export function Calendar() {
   const [events, setEvents] = useState<IEvent[]>([]);
+  const [revision, setRevision] = useState<number | null>(null);
   const [isLoading, setIsLoading] = useState(true);
   const [error, setError] = useState<string | null>(null);
 
@@ -17,9 +18,10 @@ export function Calendar() {
     const fetchEvents = async () => {
       try {
         setIsLoading(true);
-        const data = await getEvents();
+        const { events: data, revision } = await getEventsSnapshot();
         console.log("Fetched events:", data);
         setEvents(data);
+        setRevision(revision);
         setError(null);
       } catch (err) {
         console.error("Error loading events:", err);
@@ -63,7 +65,7 @@ export function Calendar() {
   }
 
   return (
-    <CalendarProvider events={events} view="bulan">
+    <CalendarProvider events={events} revision={revision} view="bulan">
       <DndProvider showConfirmation={false}>
         <div className="w-full h-full flex flex-col border rounded-xl overflow-hidden">
           <CalendarHeader />
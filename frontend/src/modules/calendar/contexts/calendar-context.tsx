@@ -2,8 +2,10 @@
 
 import type React from "react";
 import { createContext, useContext, useState } from "react";
-import { useLocalStorage } from "@/modules/calendar/hooks";
+import { toast } from "sonner";
+import { useEventStream, useLocalStorage } from "@/modules/calendar/hooks";
 import type { IEvent, IUser } from "@/modules/calendar/interfaces";
+import type { IEventChanges } from "@/modules/calendar/requests";
 import type { TCalendarView, TEventColor } from "@/modules/calendar/types";
 
 interface ICalendarContext {
@@ -68,11 +70,14 @@ const CalendarContext = createContext({} as ICalendarContext);
 export function CalendarProvider({
   children,
   events,
+  revision = null,
   badge = "colored",
   view = "minggu",
 }: {
   children: React.ReactNode;
   events: IEvent[];
+  // Data revision `events` reflects; live updates continue from here.
+  revision?: number | null;
   view?: TCalendarView;
   badge?: "dot" | "colored";
 }) {
@@ -190,6 +195,27 @@ export function CalendarProvider({
     setFilteredEvents(applyColorFilter(nextEvents));
   };
 
+  const applyChanges = ({ upserts, deletes }: IEventChanges) => {
+    const changedIds = new Set([...deletes, ...upserts.map((e) => e.id)]);
+    const nextEvents = [
+      ...allEvents.filter((e) => !changedIds.has(e.id)),
+      ...upserts,
+    ];
+    setAllEvents(nextEvents);
+    setFilteredEvents(applyColorFilter(nextEvents));
+  };
+
+  const replaceEvents = (nextEvents: IEvent[]) => {
+    setAllEvents(nextEvents);
+    setFilteredEvents(applyColorFilter(nextEvents));
+  };
+
+  useEventStream(revision, {
+    onChanges: applyChanges,
+    onReset: replaceEvents,
+    onAlarm: ({ title }) => toast.info(`⏰ ${title}`),
+  });
+
   const clearFilter = () => {
     setFilteredEvents(allEvents);
     setSelectedColors([]);
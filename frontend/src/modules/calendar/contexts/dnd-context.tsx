@@ -13,6 +13,7 @@ import { toast } from "sonner";
 import { useCalendar } from "@/modules/calendar/contexts/calendar-context";
 import type { IEvent } from "@/modules/calendar/interfaces";
 import { DndConfirmationDialog } from "@/modules/calendar/dialogs/dnd-confirmation-dialog";
+import { patchEvent } from "@/modules/calendar/requests";
 
 interface PendingDropData {
   event: IEvent;
@@ -159,12 +160,12 @@ export function DndProvider({
   const handleEventUpdate = useCallback(
     async (event: IEvent, newStartDate: Date, newEndDate: Date) => {
       try {
-        const updatedEvent = {
-          ...event,
+        const times = {
           startDate: newStartDate.toISOString(),
           endDate: newEndDate.toISOString(),
         };
-        await updateEvent(updatedEvent);
+        await patchEvent(event.id, times);
+        updateEvent({ ...event, ...times });
         toast.success("Event updated successfully");
       } catch {
         toast.error("Failed to update event");
@@ -11,11 +11,13 @@ import {
 import { motion } from "framer-motion";
 import { Resizable, type ResizeCallback } from "re-resizable";
 import type React from "react";
-import { useCallback, useMemo, useState } from "react";
+import { useCallback, useMemo, useRef, useState } from "react";
+import { toast } from "sonner";
 import { cn } from "@/lib/utils";
 import { useCalendar } from "@/modules/calendar/contexts/calendar-context";
 
 import type { IEvent } from "@/modules/calendar/interfaces";
+import { patchEvent } from "@/modules/calendar/requests";
 
 interface ResizableEventBlockProps {
   event: IEvent;
@@ -39,6 +41,10 @@ export function ResizableEvent({
     start: string;
     end: string;
   } | null>(null);
+  // Latest resized range; only this one is sent to the backend on release.
+  const pendingTimes = useRef<{ startDate: string; endDate: string } | null>(
+    null
+  );
 
   const start = useMemo(() => parseISO(event.startDate), [event.startDate]);
   const end = useMemo(() => parseISO(event.endDate), [event.endDate]);
@@ -91,11 +97,12 @@ export function ResizableEvent({
         end: format(newEnd, use24HourFormat ? "HH:mm" : "h:mm a"),
       });
 
-      updateEvent({
-        ...event,
+      const times = {
         startDate: newStart.toISOString(),
         endDate: newEnd.toISOString(),
-      });
+      };
+      pendingTimes.current = times;
+      updateEvent({ ...event, ...times });
     },
     [
       start,
@@ -111,7 +118,15 @@ export function ResizableEvent({
   const handleResizeStop = useCallback(() => {
     setIsResizing(false);
     setResizePreview(null);
-  }, []);
+
+    const times = pendingTimes.current;
+    pendingTimes.current = null;
+    if (times) {
+      patchEvent(event.id, times).catch(() => {
+        toast.error("Failed to update event");
+      });
+    }
+  }, [event.id]);
 
   const resizeConfig = useMemo(
     () => ({
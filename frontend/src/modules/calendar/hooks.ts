@@ -1,4 +1,12 @@
-import { useEffect, useState } from "react";
+import { useEffect, useRef, useState } from "react";
+import type { IEvent } from "@/modules/calendar/interfaces";
+import {
+  getEventChanges,
+  getEventsSnapshot,
+  openEventStream,
+  type IEventChanges,
+  type TEventStreamMessage,
+} from "@/modules/calendar/requests";
 
 export function useDisclosure({
   defaultIsOpen = false,
@@ -69,3 +77,83 @@ export function useMediaQuery(query: string): boolean {
 
   return matches;
 }
+
+interface IEventStreamHandlers {
+  onChanges: (changes: IEventChanges) => void;
+  // The change log could not be replayed (e.g. 410); replace everything.
+  onReset: (events: IEvent[]) => void;
+  onAlarm?: (alarm: { id: string; title: string }) => void;
+}
+
+const RECONNECT_MIN_MS = 1000;
+const RECONNECT_MAX_MS = 30000;
+
+// Keeps events current from the backend's /api/stream push channel:
+// each announced revision is fetched as a delta from the revision the
+// caller's events reflect. Reconnects with backoff; the "hello" sent on
+// every connect covers anything missed while disconnected.
+export function useEventStream(
+  revision: number | null,
+  handlers: IEventStreamHandlers
+) {
+  const handlersRef = useRef(handlers);
+  handlersRef.current = handlers;
+
+  useEffect(() => {
+    let current = revision;
+    let socket: WebSocket | null = null;
+    let reconnectTimer: ReturnType<typeof setTimeout> | undefined;
+    let reconnectDelay = RECONNECT_MIN_MS;
+    let syncing = Promise.resolve();
+    let closed = false;
+
+    const sync = async (target: number) => {
+      try {
+        if (current === null) throw new Error("No revision to sync from");
+        while (current < target) {
+          const changes = await getEventChanges(current);
+          current = changes.revision;
+          if (changes.upserts.length > 0 || changes.deletes.length > 0) {
+            handlersRef.current.onChanges(changes);
+          }
+          if (!changes.hasMore) break;
+        }
+      } catch (err) {
+        console.warn("Event delta sync failed, reloading all events:", err);
+        const snapshot = await getEventsSnapshot();
+        current = snapshot.revision ?? target;
+        handlersRef.current.onReset(snapshot.events);
+      }
+    };
+
+    const connect = () => {
+      socket = openEventStream();
+      socket.onopen = () => {
+        reconnectDelay = RECONNECT_MIN_MS;
+      };
+      socket.onmessage = (message) => {
+        const data = JSON.parse(message.data) as TEventStreamMessage;
+        if (data.type === "alarm") {
+          handlersRef.current.onAlarm?.(data);
+          return;
+        }
+        // One sync at a time, in order.
+        syncing = syncing
+          .then(() => (closed ? undefined : sync(data.revision)))
+          .catch((err) => console.error("Error syncing events:", err));
+      };
+      socket.onclose = () => {
+        if (closed) return;
+        reconnectTimer = setTimeout(connect, reconnectDelay);
+        reconnectDelay = Math.min(reconnectDelay * 2, RECONNECT_MAX_MS);
+      };
+    };
+
+    connect();
+    return () => {
+      closed = true;
+      clearTimeout(reconnectTimer);
+      socket?.close();
+    };
+  }, [revision]);
+}
@@ -16,6 +16,9 @@ export interface IEvent {
   description: string;
   reminderTime?: string; // Optional: When to show reminder (ISO datetime)
   isReminderEnabled?: boolean; // Whether reminder is active
+  recurrenceRule?: string; // Optional: RRULE subset, e.g. "FREQ=WEEKLY;COUNT=10"
+  recurrenceExceptions?: string; // Optional: comma-separated occurrence starts to skip
+  seriesId?: string; // Set on occurrences expanded from a recurring event
 }
 
 export interface ICalendarCell {
@@ -9,6 +9,50 @@ export const getEvents = async (): Promise<IEvent[]> => {
   return response.json();
 };
 
+// Events plus the data revision they reflect, for use with getEventChanges().
+export const getEventsSnapshot = async (): Promise<{
+  events: IEvent[];
+  revision: number | null;
+}> => {
+  const response = await fetch(`${API_BASE_URL}/api/event`);
+  if (!response.ok) throw new Error("Failed to fetch events");
+  const revision = response.headers.get("X-Data-Revision");
+  return {
+    events: await response.json(),
+    revision: revision === null ? null : Number(revision),
+  };
+};
+
+export interface IEventChanges {
+  revision: number;
+  upserts: IEvent[];
+  deletes: string[];
+  hasMore: boolean;
+}
+
+// Events changed after `since`. A 410 means the server no longer goes back
+// that far; fall back to getEvents().
+export const getEventChanges = async (
+  since: number,
+  limit?: number
+): Promise<IEventChanges> => {
+  const params = new URLSearchParams({ since: String(since) });
+  if (limit) params.set("limit", String(limit));
+  const response = await fetch(`${API_BASE_URL}/api/event/changes?${params}`);
+  if (!response.ok)
+    throw new Error(`Failed to fetch event changes (${response.status})`);
+  return response.json();
+};
+
+export type TEventStreamMessage =
+  | { type: "hello"; revision: number }
+  | { type: "changes"; revision: number }
+  | { type: "alarm"; id: string; title: string };
+
+// Push channel for changes and alarms; see useEventStream().
+export const openEventStream = (): WebSocket =>
+  new WebSocket(`${API_BASE_URL.replace(/^http/, "ws")}/api/stream`);
+
 export const createEvent = async (
   event: Omit<IEvent, "id">
 ): Promise<IEvent> => {
@@ -38,6 +82,21 @@ export const updateEvent = async (
   return response.json();
 };
 
+export const patchEvent = async (
+  id: string,
+  fields: Partial<Omit<IEvent, "id">>
+): Promise<IEvent> => {
+  const response = await fetch(`${API_BASE_URL}/api/event/${id}`, {
+    method: "PATCH",
+    headers: {
+      "Content-Type": "application/json",
+    },
+    body: JSON.stringify(fields),
+  });
+  if (!response.ok) throw new Error("Failed to update event");
+  return response.json();
+};
+
 export const deleteEvent = async (id: string): Promise<void> => {
   const response = await fetch(`${API_BASE_URL}/api/event/${id}`, {
     method: "DELETE",
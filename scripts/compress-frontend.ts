@@ -0,0 +1,67 @@
+#!/usr/bin/env tsx
+
+/**
+ * Precompresses the static frontend export for the Qt backend.
+ *
+ * Writes a .br and a .gz next to every compressible file in frontend/out,
+ * which the backend's static asset cache serves by Accept-Encoding.
+ * Runs automatically after `npm run build` in the frontend.
+ *
+ * Usage:
+ *   npx tsx scripts/compress-frontend.ts [outDir]
+ */
+
+import { readdirSync, readFileSync, statSync, writeFileSync } from "node:fs";
+import { join, resolve } from "node:path";
+import { brotliCompressSync, constants, gzipSync } from "node:zlib";
+
+const OUT_DIR = resolve(process.argv[2] ?? join(__dirname, "../frontend/out"));
+
+const COMPRESSIBLE = /\.(html|js|mjs|css|json|svg|txt|xml|map)$/;
+const MIN_BYTES = 1024;
+
+function* walk(dir: string): Generator<string> {
+  for (const entry of readdirSync(dir, { withFileTypes: true })) {
+    const path = join(dir, entry.name);
+    if (entry.isDirectory()) {
+      yield* walk(path);
+    } else if (entry.isFile()) {
+      yield path;
+    }
+  }
+}
+
+let files = 0;
+let originalBytes = 0;
+let brotliBytes = 0;
+
+for (const path of walk(OUT_DIR)) {
+  if (!COMPRESSIBLE.test(path) || statSync(path).size < MIN_BYTES) {
+    continue;
+  }
+
+  const data = readFileSync(path);
+  const brotli = brotliCompressSync(data, {
+    params: {
+      [constants.BROTLI_PARAM_QUALITY]: constants.BROTLI_MAX_QUALITY,
+      [constants.BROTLI_PARAM_SIZE_HINT]: data.length,
+    },
+  });
+  const gzip = gzipSync(data, { level: 9 });
+
+  // A variant that barely saves anything only costs memory in the backend.
+  if (brotli.length < data.length * 0.9) {
+    writeFileSync(`${path}.br`, brotli);
+  }
+  if (gzip.length < data.length * 0.9) {
+    writeFileSync(`${path}.gz`, gzip);
+  }
+
+  files++;
+  originalBytes += data.length;
+  brotliBytes += brotli.length;
+}
+
+console.log(
+  `🗜️  Compressed ${files} file(s): ${(originalBytes / 1024).toFixed(0)} KB -> ${(brotliBytes / 1024).toFixed(0)} KB (brotli)`
+);
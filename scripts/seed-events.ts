@@ -63,21 +63,28 @@ function addDays(date: Date, days: number): Date {
   return result;
 }
 
+interface IBatchResult {
+  ids: string[];
+  errors: { index: number; error: string }[];
+}
+
 /**
- * Create an event via Qt backend API
+ * Create all events in one transaction via the batch import endpoint
  */
-async function createEvent(event: Omit<IEvent, "id">): Promise<IEvent> {
-  const response = await fetch(`${API_BASE_URL}/api/event`, {
+async function createEvents(
+  events: Omit<IEvent, "id">[]
+): Promise<IBatchResult> {
+  const response = await fetch(`${API_BASE_URL}/api/event/batch`, {
     method: "POST",
     headers: {
       "Content-Type": "application/json",
     },
-    body: JSON.stringify(event),
+    body: JSON.stringify(events),
   });
 
-  if (!response.ok) {
+  if (!response.ok && response.status !== 400) {
     const error = await response.text();
-    throw new Error(`Failed to create event: ${response.status} - ${error}`);
+    throw new Error(`Failed to import events: ${response.status} - ${error}`);
   }
 
   return response.json();
@@ -302,26 +309,25 @@ async function seedEvents() {
   const events = generateSampleEvents();
   console.log(`📝 Generating ${events.length} sample events...\n`);
 
-  let successCount = 0;
-  let failCount = 0;
+  const result = await createEvents(events);
+  const successCount = result.ids.length;
+  const failCount = result.errors.length;
+  const failures = new Map(result.errors.map((e) => [e.index, e.error]));
 
-  for (let i = 0; i < events.length; i++) {
-    const event = events[i];
-    try {
-      const created = await createEvent(event);
-      successCount++;
-      console.log(`✅ [${i + 1}/${events.length}] Created: "${event.title}"`);
-      console.log(
-        `   └─ ID: ${created.id}, Category: ${event.category}, Color: ${event.color}`
-      );
-    } catch (error) {
-      failCount++;
+  let createdIndex = 0;
+  events.forEach((event, i) => {
+    const error = failures.get(i);
+    if (error !== undefined) {
       console.error(`❌ [${i + 1}/${events.length}] Failed: "${event.title}"`);
-      console.error(
-        `   └─ Error: ${error instanceof Error ? error.message : String(error)}`
-      );
+      console.error(`   └─ Error: ${error}`);
+      return;
     }
-  }
+    const id = result.ids[createdIndex++];
+    console.log(`✅ [${i + 1}/${events.length}] Created: "${event.title}"`);
+    console.log(
+      `   └─ ID: ${id}, Category: ${event.category}, Color: ${event.color}`
+    );
+  });
 
   console.log("\n" + "=".repeat(60));
   console.log(`📊 Seeding Summary:`);